@@ -58,6 +58,7 @@ void Config::ReadValues() {
 
     // Core
     Settings::values.frame_skip = glfw_config->GetInteger("Core", "frame_skip", 0);
+    Settings::values.use_cpu_jit = glfw_config->GetBoolean("Core", "use_cpu_jit", false);
 
     // Renderer
     Settings::values.use_hw_renderer = glfw_config->GetBoolean("Renderer", "use_hw_renderer", false);
@@ -79,6 +80,9 @@ void Config::ReadValues() {
     // Debugging
     Settings::values.use_gdbstub = glfw_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port = glfw_config->GetInteger("Debugging", "gdbstub_port", 24689);
+    Settings::values.use_block_profiler = glfw_config->GetBoolean("Debugging", "use_block_profiler", false);
+    Settings::values.use_perf_map = glfw_config->GetBoolean("Debugging", "use_perf_map", false);
+    Settings::values.use_jitdump = glfw_config->GetBoolean("Debugging", "use_jitdump", false);
 }
 
 void Config::Reload() {
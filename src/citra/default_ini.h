@@ -37,6 +37,10 @@ pad_cright =
 # 0 (default): No frameskip, 1: x2 frameskip, 2: x4 frameskip, 3: x8 frameskip, etc.
 frame_skip =
 
+# Whether to use the Just-In-Time (JIT) compiler for CPU emulation
+# 0 (default): Interpreter (slow), 1: JIT (fast)
+use_cpu_jit =
+
 [Renderer]
 # Whether to use software or hardware rendering.
 # 0 (default): Software, 1: Hardware
@@ -71,6 +75,19 @@ log_filter = *:Info
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
+
+# Whether to count how often each block of guest code runs in the interpreter. The hottest blocks are
+# written to block_profile.txt, and a flamegraph input to block_profile.folded, in the dump directory.
+# 0 (default): Off, 1: On
+use_block_profiler =
+
+# Whether to describe the code generated by the CPU and shader JITs to the Linux perf profiler.
+# The perf map is written to /tmp/perf-<pid>.map and read by perf report as is. The jitdump, written
+# to /tmp/jit-<pid>.dump, also contains the generated code; record with `perf record -k mono` and
+# merge it with `perf inject --jit`.
+# 0 (default): Off, 1: On
+use_perf_map =
+use_jitdump =
 )";
 
 }
@@ -40,6 +40,7 @@ void Config::ReadValues() {
 
     qt_config->beginGroup("Core");
     Settings::values.frame_skip = qt_config->value("frame_skip", 0).toInt();
+    Settings::values.use_cpu_jit = qt_config->value("use_cpu_jit", false).toBool();
     qt_config->endGroup();
 
     qt_config->beginGroup("Renderer");
@@ -66,6 +67,9 @@ void Config::ReadValues() {
     qt_config->beginGroup("Debugging");
     Settings::values.use_gdbstub = qt_config->value("use_gdbstub", false).toBool();
     Settings::values.gdbstub_port = qt_config->value("gdbstub_port", 24689).toInt();
+    Settings::values.use_block_profiler = qt_config->value("use_block_profiler", false).toBool();
+    Settings::values.use_perf_map = qt_config->value("use_perf_map", false).toBool();
+    Settings::values.use_jitdump = qt_config->value("use_jitdump", false).toBool();
     qt_config->endGroup();
 }
 
@@ -79,6 +83,7 @@ void Config::SaveValues() {
 
     qt_config->beginGroup("Core");
     qt_config->setValue("frame_skip", Settings::values.frame_skip);
+    qt_config->setValue("use_cpu_jit", Settings::values.use_cpu_jit);
     qt_config->endGroup();
 
     qt_config->beginGroup("Renderer");
@@ -106,6 +111,9 @@ void Config::SaveValues() {
     qt_config->beginGroup("Debugging");
     qt_config->setValue("use_gdbstub", Settings::values.use_gdbstub);
     qt_config->setValue("gdbstub_port", Settings::values.gdbstub_port);
+    qt_config->setValue("use_block_profiler", Settings::values.use_block_profiler);
+    qt_config->setValue("use_perf_map", Settings::values.use_perf_map);
+    qt_config->setValue("use_jitdump", Settings::values.use_jitdump);
     qt_config->endGroup();
 }
 
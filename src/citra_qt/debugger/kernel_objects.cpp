@@ -0,0 +1,45 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <QTreeWidget>
+
+#include "citra_qt/debugger/kernel_objects.h"
+
+#include "core/hle/kernel/slab_allocator.h"
+
+KernelObjectsWidget::KernelObjectsWidget(QWidget* parent) : QDockWidget(tr("Kernel Objects"), parent)
+{
+    setObjectName("KernelObjects");
+
+    allocator_list = new QTreeWidget;
+    allocator_list->setRootIsDecorated(false);
+    allocator_list->setHeaderLabels(QStringList() << tr("Type") << tr("Object Size") << tr("Live")
+                                                  << tr("Peak") << tr("Capacity") << tr("Allocations"));
+    setWidget(allocator_list);
+}
+
+void KernelObjectsWidget::OnDebugModeEntered()
+{
+    allocator_list->clear();
+
+    for (const Kernel::SlabAllocator* allocator : Kernel::GetSlabAllocators()) {
+        QStringList columns;
+        columns << QString::fromLatin1(allocator->GetName())
+                << QString::number(allocator->GetObjectSize())
+                << QString::number(allocator->GetNumLiveObjects())
+                << QString::number(allocator->GetPeakLiveObjects())
+                << QString::number(allocator->GetCapacity())
+                << QString::number(allocator->GetNumAllocations());
+
+        QTreeWidgetItem* item = new QTreeWidgetItem(columns);
+        for (int column = 1; column < columns.size(); ++column)
+            item->setTextAlignment(column, Qt::AlignRight);
+        allocator_list->addTopLevelItem(item);
+    }
+}
+
+void KernelObjectsWidget::OnDebugModeLeft()
+{
+
+}
@@ -0,0 +1,28 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <QDockWidget>
+
+class QTreeWidget;
+
+/**
+ * Shows the allocation statistics of the slab allocators of the kernel objects. They are
+ * refreshed when emulation is paused in the debugger.
+ */
+class KernelObjectsWidget : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+    KernelObjectsWidget(QWidget* parent = nullptr);
+
+public slots:
+    void OnDebugModeEntered();
+    void OnDebugModeLeft();
+
+private:
+    QTreeWidget* allocator_list;
+};
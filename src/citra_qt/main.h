@@ -21,6 +21,7 @@ class RegistersWidget;
 class CallstackWidget;
 class GPUCommandStreamWidget;
 class GPUCommandListWidget;
+class KernelObjectsWidget;
 
 class GMainWindow : public QMainWindow
 {
@@ -120,6 +121,7 @@ private:
     CallstackWidget* callstackWidget;
     GPUCommandStreamWidget* graphicsWidget;
     GPUCommandListWidget* graphicsCommandsWidget;
+    KernelObjectsWidget* kernelObjectsWidget;
 
     QAction* actions_recent_files[max_recent_files_item];
 };
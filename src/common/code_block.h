@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <string>
+
 #include "common_types.h"
+#include "jit_profiling.h"
 #include "memory_util.h"
 
 // Everything that needs to generate code should inherit from this.
@@ -84,4 +87,12 @@ public:
     size_t GetOffset(const u8 *ptr) const {
         return ptr - region;
     }
+
+    // Call this after generating a function, with the pointer it starts at, to make the code
+    // emitted since then show up under the given name in profilers. See jit_profiling.h.
+    void RegisterCode(const u8 *start, const std::string& name) const
+    {
+        if (JitProfiling::IsEnabled())
+            JitProfiling::RegisterCode(start, T::GetCodePtr() - start, name);
+    }
 };
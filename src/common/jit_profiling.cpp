@@ -0,0 +1,187 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <mutex>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/jit_profiling.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+
+#ifdef __linux__
+#include <ctime>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace JitProfiling {
+
+#ifdef __linux__
+
+// Layout of the jitdump format, as documented in tools/perf/Documentation/jitdump-specification.txt
+// of the Linux sources
+
+static const u32 JITDUMP_MAGIC = 0x4A695444; // "JiTD"
+static const u32 JITDUMP_VERSION = 1;
+static const u32 JIT_CODE_LOAD = 0;
+
+#ifdef ARCHITECTURE_x86_64
+static const u32 ELF_MACHINE = 62; // EM_X86_64
+#else
+static const u32 ELF_MACHINE = 0; // EM_NONE
+#endif
+
+struct JitDumpHeader {
+    u32 magic;
+    u32 version;
+    u32 total_size;
+    u32 elf_mach;
+    u32 pad1;
+    u32 pid;
+    u64 timestamp;
+    u64 flags;
+};
+
+struct JitDumpCodeLoad {
+    u32 id;
+    u32 total_size;
+    u64 timestamp;
+    u32 pid;
+    u32 tid;
+    u64 vma;
+    u64 code_addr;
+    u64 code_size;
+    u64 code_index;
+    // Followed by the null-terminated name and the code
+};
+
+static std::mutex mutex;
+static FileUtil::IOFile perf_map_file;
+static FileUtil::IOFile jitdump_file;
+/// Mapping of the jitdump file, which is how perf record learns about the file
+static void* jitdump_marker = nullptr;
+static u64 code_index = 0;
+
+/// Timestamp in the clock used by `perf record -k mono`
+static u64 GetTimestamp() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<u64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static void OpenPerfMap() {
+    const std::string path = Common::StringFromFormat("/tmp/perf-%d.map", getpid());
+    if (!perf_map_file.Open(path, "w")) {
+        LOG_ERROR(Common, "Failed to open the perf map %s", path.c_str());
+        return;
+    }
+    LOG_INFO(Common, "Writing the perf map of JIT code to %s", path.c_str());
+}
+
+static void OpenJitDump() {
+    const std::string path = Common::StringFromFormat("/tmp/jit-%d.dump", getpid());
+    if (!jitdump_file.Open(path, "w+b")) {
+        LOG_ERROR(Common, "Failed to open the jitdump file %s", path.c_str());
+        return;
+    }
+
+    // perf record finds the file through this executable mapping of it
+    const long page_size = sysconf(_SC_PAGESIZE);
+    jitdump_marker = mmap(nullptr, page_size, PROT_READ | PROT_EXEC, MAP_PRIVATE,
+                          fileno(jitdump_file.GetHandle()), 0);
+    if (jitdump_marker == MAP_FAILED) {
+        LOG_ERROR(Common, "Failed to map the jitdump file %s", path.c_str());
+        jitdump_marker = nullptr;
+        jitdump_file.Close();
+        return;
+    }
+
+    JitDumpHeader header = {};
+    header.magic = JITDUMP_MAGIC;
+    header.version = JITDUMP_VERSION;
+    header.total_size = sizeof(header);
+    header.elf_mach = ELF_MACHINE;
+    header.pid = getpid();
+    header.timestamp = GetTimestamp();
+    jitdump_file.WriteObject(header);
+    jitdump_file.Flush();
+
+    LOG_INFO(Common, "Writing the jitdump of JIT code to %s", path.c_str());
+}
+
+void Init(bool perf_map, bool jitdump) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (perf_map && !perf_map_file.IsOpen())
+        OpenPerfMap();
+    if (jitdump && !jitdump_file.IsOpen())
+        OpenJitDump();
+}
+
+void Shutdown() {
+    std::lock_guard<std::mutex> lock(mutex);
+    perf_map_file.Close();
+    if (jitdump_marker != nullptr) {
+        munmap(jitdump_marker, sysconf(_SC_PAGESIZE));
+        jitdump_marker = nullptr;
+    }
+    jitdump_file.Close();
+}
+
+bool IsEnabled() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return perf_map_file.IsOpen() || jitdump_file.IsOpen();
+}
+
+void RegisterCode(const void* start, size_t size, const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (size == 0)
+        return;
+
+    if (perf_map_file.IsOpen()) {
+        const std::string line = Common::StringFromFormat("%llx %zx %s\n",
+            static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(start)), size, name.c_str());
+        perf_map_file.WriteBytes(line.data(), line.size());
+        perf_map_file.Flush();
+    }
+
+    if (jitdump_file.IsOpen()) {
+        JitDumpCodeLoad record;
+        record.id = JIT_CODE_LOAD;
+        record.total_size = static_cast<u32>(sizeof(record) + name.size() + 1 + size);
+        record.timestamp = GetTimestamp();
+        record.pid = getpid();
+        record.tid = static_cast<u32>(syscall(SYS_gettid));
+        record.vma = reinterpret_cast<uintptr_t>(start);
+        record.code_addr = reinterpret_cast<uintptr_t>(start);
+        record.code_size = size;
+        record.code_index = code_index++;
+        jitdump_file.WriteObject(record);
+        jitdump_file.WriteBytes(name.c_str(), name.size() + 1);
+        jitdump_file.WriteBytes(start, size);
+        jitdump_file.Flush();
+    }
+}
+
+#else
+
+void Init(bool perf_map, bool jitdump) {
+    if (perf_map || jitdump)
+        LOG_WARNING(Common, "JIT profiling output is only supported on Linux");
+}
+
+void Shutdown() {
+}
+
+bool IsEnabled() {
+    return false;
+}
+
+void RegisterCode(const void* start, size_t size, const std::string& name) {
+}
+
+#endif
+
+} // namespace JitProfiling
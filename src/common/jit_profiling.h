@@ -0,0 +1,47 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Describes the code generated by the JITs to the Linux perf profiler, which otherwise only sees
+ * anonymous addresses in the executable memory.
+ *
+ * Two formats are supported:
+ * - The perf map, /tmp/perf-<pid>.map, with one "start size name" line per code region. perf
+ *   report reads it directly.
+ * - The jitdump format, /tmp/jit-<pid>.dump, which also contains a copy of the code, so that the
+ *   generated instructions can be annotated. It has to be merged into the recording with
+ *   `perf inject --jit` and requires recording with `perf record -k mono`.
+ *
+ * Code regions are registered through CodeBlock::RegisterCode, so every JIT deriving from it can
+ * name the code it emits. Registering is a no-op unless one of the formats has been enabled, and
+ * on platforms other than Linux.
+ */
+namespace JitProfiling {
+
+/**
+ * Opens the output files of the enabled formats. Regions registered afterwards are written to
+ * them until Shutdown.
+ */
+void Init(bool perf_map, bool jitdump);
+
+/// Closes the output files
+void Shutdown();
+
+/// Returns true if code regions are currently being recorded
+bool IsEnabled();
+
+/**
+ * Records a region of generated code.
+ * @param start Start address of the code
+ * @param size Size of the code in bytes
+ * @param name Name the region is reported under, eg. the guest address it was compiled from
+ */
+void RegisterCode(const void* start, size_t size, const std::string& name);
+
+} // namespace JitProfiling
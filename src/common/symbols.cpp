@@ -37,6 +37,19 @@ namespace Symbols
         return {};
     }
 
+    TSymbol GetContainingSymbol(u32 address)
+    {
+        auto iter = g_symbols.upper_bound(address);
+        if (iter == g_symbols.begin())
+            return {};
+
+        --iter;
+        if (address - iter->second.address < iter->second.size)
+            return iter->second;
+
+        return {};
+    }
+
     const std::string GetName(u32 address)
     {
         return GetSymbol(address).name;
@@ -27,6 +27,8 @@ namespace Symbols
 
     void Add(u32 address, const std::string& name, u32 size, u32 type);
     TSymbol GetSymbol(u32 address);
+    /// Returns the symbol whose address range contains the given address, or an empty symbol
+    TSymbol GetContainingSymbol(u32 address);
     const std::string GetName(u32 address);
     void Remove(u32 address);
     void Clear();
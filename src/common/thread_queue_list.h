@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <deque>
 
 #include <boost/range/algorithm_ext/erase.hpp>
 
+#include "common/bit_set.h"
+#include "common/common_types.h"
+
 namespace Common {
 
 template<class T, unsigned int N>
@@ -23,7 +27,7 @@ struct ThreadQueueList {
     static const Priority NUM_QUEUES = N;
 
     ThreadQueueList() {
-        first = nullptr;
+        nonempty.fill(0);
     }
 
     // Only for debugging, returns priority level.
@@ -39,65 +43,43 @@ struct ThreadQueueList {
     }
 
     T get_first() {
-        Queue *cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                return cur->data.front();
-            }
-            cur = cur->next_nonempty;
-        }
+        Priority priority = first_nonempty(NUM_QUEUES);
+        if (priority == NUM_QUEUES)
+            return T();
 
-        return T();
+        return queues[priority].data.front();
     }
 
     T pop_first() {
-        Queue *cur = first;
-        while (cur != nullptr) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
-        }
-
-        return T();
+        return pop(first_nonempty(NUM_QUEUES));
     }
 
     T pop_first_better(Priority priority) {
-        Queue *cur = first;
-        Queue *stop = &queues[priority];
-        while (cur < stop) {
-            if (!cur->data.empty()) {
-                auto tmp = std::move(cur->data.front());
-                cur->data.pop_front();
-                return tmp;
-            }
-            cur = cur->next_nonempty;
-        }
-
-        return T();
+        return pop(first_nonempty(priority));
     }
 
     void push_front(Priority priority, const T& thread_id) {
         Queue *cur = &queues[priority];
         cur->data.push_front(thread_id);
+        set_nonempty(priority);
     }
 
     void push_back(Priority priority, const T& thread_id) {
         Queue *cur = &queues[priority];
         cur->data.push_back(thread_id);
+        set_nonempty(priority);
     }
 
     void move(const T& thread_id, Priority old_priority, Priority new_priority) {
         remove(old_priority, thread_id);
-        prepare(new_priority);
         push_back(new_priority, thread_id);
     }
 
     void remove(Priority priority, const T& thread_id) {
         Queue *cur = &queues[priority];
         boost::remove_erase(cur->data, thread_id);
+        if (cur->data.empty())
+            clear_nonempty(priority);
     }
 
     void rotate(Priority priority) {
@@ -111,7 +93,7 @@ struct ThreadQueueList {
 
     void clear() {
         queues.fill(Queue());
-        first = nullptr;
+        nonempty.fill(0);
     }
 
     bool empty(Priority priority) const {
@@ -119,42 +101,53 @@ struct ThreadQueueList {
         return cur->data.empty();
     }
 
-    void prepare(Priority priority) {
-        Queue* cur = &queues[priority];
-        if (cur->next_nonempty == UnlinkedTag())
-            link(priority);
-    }
-
 private:
     struct Queue {
-        // Points to the next active priority, skipping over ones that have never been used.
-        Queue* next_nonempty = UnlinkedTag();
         // Double-ended queue of threads in this priority level
         std::deque<T> data;
     };
 
-    /// Special tag used to mark priority levels that have never been used.
-    static Queue* UnlinkedTag() {
-        return reinterpret_cast<Queue*>(1);
+    static const size_t NUM_WORDS = (NUM_QUEUES + 63) / 64;
+
+    /**
+     * Finds the first (most important) non-empty priority level
+     * @param limit Only levels before this one are considered
+     * @return The priority level, or NUM_QUEUES if all the considered levels are empty
+     */
+    Priority first_nonempty(Priority limit) const {
+        for (size_t i = 0; i < NUM_WORDS; ++i) {
+            if (nonempty[i] != 0) {
+                Priority priority = static_cast<Priority>(i * 64 + LeastSignificantSetBit(nonempty[i]));
+                return priority < limit ? priority : NUM_QUEUES;
+            }
+        }
+
+        return NUM_QUEUES;
     }
 
-    void link(Priority priority) {
+    /// Pops the first thread of a priority level, which may be NUM_QUEUES to pop nothing
+    T pop(Priority priority) {
+        if (priority == NUM_QUEUES)
+            return T();
+
         Queue *cur = &queues[priority];
+        auto tmp = std::move(cur->data.front());
+        cur->data.pop_front();
+        if (cur->data.empty())
+            clear_nonempty(priority);
+        return tmp;
+    }
 
-        for (int i = priority - 1; i >= 0; --i) {
-            if (queues[i].next_nonempty != UnlinkedTag()) {
-                cur->next_nonempty = queues[i].next_nonempty;
-                queues[i].next_nonempty = cur;
-                return;
-            }
-        }
+    void set_nonempty(Priority priority) {
+        nonempty[priority / 64] |= u64(1) << (priority % 64);
+    }
 
-        cur->next_nonempty = first;
-        first = cur;
+    void clear_nonempty(Priority priority) {
+        nonempty[priority / 64] &= ~(u64(1) << (priority % 64));
     }
 
-    // The first queue that's ever been used.
-    Queue* first;
+    // Bitmap of the priority levels that have threads in them, in which bit N is level N.
+    std::array<u64, NUM_WORDS> nonempty;
     // The priority level queues of thread ids.
     std::array<Queue, NUM_QUEUES> queues;
 };
@@ -11,6 +11,10 @@ namespace Core {
     struct ThreadContext;
 }
 
+namespace Memory {
+    struct PageTable;
+}
+
 /// Generic ARM11 CPU interface
 class ARM_Interface : NonCopyable {
 public:
@@ -141,6 +145,27 @@ public:
     /// Prepare core for thread reschedule (if needed to correctly handle state)
     virtual void PrepareReschedule() = 0;
 
+    /**
+     * Discards any code translated from the given address space starting in the given guest page.
+     * The address space doesn't have to be the current one.
+     * @param page_table Page table of the address space
+     * @param addr Address inside the page whose code has been modified or unmapped
+     */
+    virtual void InvalidateCodePage(const Memory::PageTable& page_table, u32 addr) = 0;
+
+    /**
+     * Discards all the code translated from the given address space, used when its page table is
+     * reset or destroyed
+     * @param page_table Page table of the address space
+     */
+    virtual void ClearInstructionCache(const Memory::PageTable& page_table) = 0;
+
+    /**
+     * Loads the code translated in previous runs of a program from disk, if the core supports it
+     * @param program_id Program ID of the launched title
+     */
+    virtual void LoadTranslationCache(u64 program_id) = 0;
+
     /// Getter for num_instructions
     u64 GetNumInstructions() const {
         return num_instructions;
@@ -0,0 +1,98 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+
+#include "core/memory.h"
+
+/**
+ * Two-level table mapping guest addresses to translated blocks, laid out like Memory::PageTable.
+ * The first level is indexed by the guest page number and the second level by the halfword offset
+ * within the page, so looking up a block costs two indexed loads and no hashing. Pages without any
+ * block all share a single read-only page filled with the invalid value, which is why the table
+ * can't be copied.
+ *
+ * @tparam T Type of the block handle stored in the table
+ */
+template <typename T>
+class BlockTable : NonCopyable {
+public:
+    /// Number of guest pages covered by the table
+    static const size_t NUM_PAGES = 1 << (32 - Memory::PAGE_BITS);
+    /// Number of block entries per page, one for every halfword aligned address
+    static const size_t ENTRIES_PER_PAGE = Memory::PAGE_SIZE / 2;
+
+    /**
+     * @param invalid_block Value returned by Find for addresses without an associated block
+     */
+    explicit BlockTable(T invalid_block) : invalid_block(invalid_block), pages(NUM_PAGES, &empty_page) {
+        empty_page.fill(invalid_block);
+    }
+
+    /**
+     * Finds the block starting at the given address.
+     * @param addr Guest address of the block, must be at least halfword aligned
+     * @return The block starting at addr, or the invalid value if there is none
+     */
+    T Find(u32 addr) const {
+        return (*pages[addr >> Memory::PAGE_BITS])[(addr & Memory::PAGE_MASK) >> 1];
+    }
+
+    /**
+     * Associates a block with the given address, replacing any previous block there.
+     * @param addr Guest address of the block, must be at least halfword aligned
+     * @param block Block to insert
+     */
+    void Insert(u32 addr, T block) {
+        Page*& page = pages[addr >> Memory::PAGE_BITS];
+        if (page == &empty_page) {
+            page_storage.emplace_back(new Page);
+            page = page_storage.back().get();
+            allocated_pages.push_back(addr >> Memory::PAGE_BITS);
+            page->fill(invalid_block);
+        }
+        (*page)[(addr & Memory::PAGE_MASK) >> 1] = block;
+    }
+
+    /**
+     * Removes all blocks starting within the page containing the given address. The page storage
+     * is kept around so that retranslating the page does not have to allocate it again.
+     */
+    void InvalidatePage(u32 addr) {
+        Page* page = pages[addr >> Memory::PAGE_BITS];
+        if (page != &empty_page)
+            page->fill(invalid_block);
+    }
+
+    /// Removes all blocks from the table and releases the page storage
+    void Clear() {
+        // Only the allocated pages are reset, filling the whole first level would cost several MiB
+        // of writes every time the cores switch address spaces
+        for (u32 page : allocated_pages)
+            pages[page] = &empty_page;
+        allocated_pages.clear();
+        page_storage.clear();
+    }
+
+private:
+    using Page = std::array<T, ENTRIES_PER_PAGE>;
+
+    T invalid_block;
+
+    /// Page shared by all guest pages that do not have any blocks, it is never written to
+    Page empty_page;
+    /// First level of the table, indexed by guest page number
+    std::vector<Page*> pages;
+    /// Owns the pages that have been allocated because a block was inserted into them
+    std::vector<std::unique_ptr<Page>> page_storage;
+    /// Guest page numbers of the pages in page_storage
+    std::vector<u32> allocated_pages;
+};
@@ -4,6 +4,7 @@
 
 #include <cstring>
 
+#include "common/file_util.h"
 #include "common/make_unique.h"
 
 #include "core/arm/skyeye_common/armstate.h"
@@ -16,12 +17,23 @@
 
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/settings.h"
 
 ARM_DynCom::ARM_DynCom(PrivilegeMode initial_mode) {
     state = Common::make_unique<ARMul_State>(initial_mode);
+
+    if (Settings::values.use_block_profiler)
+        state->block_profiler = Common::make_unique<BlockProfiler>();
 }
 
 ARM_DynCom::~ARM_DynCom() {
+    InterpreterCloseTranslationCache();
+    InterpreterLogBlockLinks();
+
+    if (state->block_profiler && !state->block_profiler->IsEmpty()) {
+        const std::string dump_dir = FileUtil::GetUserPath(D_DUMP_IDX);
+        state->block_profiler->WriteReport(dump_dir + "block_profile.txt", dump_dir + "block_profile.folded");
+    }
 }
 
 void ARM_DynCom::SetPC(u32 pc) {
@@ -126,3 +138,15 @@ void ARM_DynCom::LoadContext(const Core::ThreadContext& ctx) {
 void ARM_DynCom::PrepareReschedule() {
     state->NumInstrsToExecute = 0;
 }
+
+void ARM_DynCom::InvalidateCodePage(const Memory::PageTable& page_table, u32 addr) {
+    InterpreterInvalidatePage(state.get(), page_table, addr);
+}
+
+void ARM_DynCom::ClearInstructionCache(const Memory::PageTable& page_table) {
+    InterpreterClearCache(state.get(), page_table);
+}
+
+void ARM_DynCom::LoadTranslationCache(u64 program_id) {
+    InterpreterLoadTranslationCache(state.get(), program_id);
+}
@@ -41,6 +41,9 @@ public:
     void LoadContext(const Core::ThreadContext& ctx) override;
 
     void PrepareReschedule() override;
+    void InvalidateCodePage(const Memory::PageTable& page_table, u32 addr) override;
+    void ClearInstructionCache(const Memory::PageTable& page_table) override;
+    void LoadTranslationCache(u64 program_id) override;
     void ExecuteInstructions(int num_instructions) override;
 
 private:
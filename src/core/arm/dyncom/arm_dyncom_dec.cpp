@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <vector>
+
 #include "core/arm/dyncom/arm_dyncom_dec.h"
 #include "core/arm/skyeye_common/armsupp.h"
 
@@ -414,7 +417,97 @@ const InstructionSetEncodingItem arm_exclusion_code[] = {
     { "invalid", 0, INVALID,     { 0 }}
 };
 
+static const int NUM_ARM_INSTRUCTIONS = sizeof(arm_instruction) / sizeof(InstructionSetEncodingItem);
+
+// Checks whether all the bit-field conditions of an encoding item hold for the given instruction
+static bool MatchesEncoding(const InstructionSetEncodingItem& item, u32 instr) {
+    for (int n = 0, base = 0; n < item.attribute_value; n++, base += 3) {
+        if (item.content[base + 1] == 31 && item.content[base] == 0) {
+            // clrex
+            if (instr != item.content[base + 2])
+                return false;
+        } else if (BITS(instr, item.content[base], item.content[base + 1]) != item.content[base + 2]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The decode table is indexed by bits [27:20] and [7:4] of the instruction, which select the
+// instruction class in the ARM encoding.
+static const u32 DECODE_KEY_MASK = 0x0FF000F0;
+static const int NUM_DECODE_KEYS = 1 << 12;
+
+static u32 GetDecodeKey(u32 instr) {
+    return (BITS(instr, 20, 27) << 4) | BITS(instr, 4, 7);
+}
+
+// Checks whether an encoding item can match any instruction with the given decode key
+static bool IsCandidate(const InstructionSetEncodingItem& item, u32 key) {
+    const u32 key_bits = ((key >> 4) << 20) | ((key & 0xF) << 4);
+
+    for (int n = 0, base = 0; n < item.attribute_value; n++, base += 3) {
+        const u32 low = item.content[base];
+        const u32 high = item.content[base + 1];
+
+        const u32 field_mask = (high - low == 31) ? 0xFFFFFFFF : ((1U << (high - low + 1)) - 1) << low;
+        const u32 expected = item.content[base + 2] << low;
+
+        if ((key_bits ^ expected) & field_mask & DECODE_KEY_MASK)
+            return false;
+    }
+    return true;
+}
+
+namespace {
+
+/**
+ * Lists, for every decode key, the indices of the arm_instruction entries that may match an
+ * instruction with that key, in table order. Decoding only has to test these candidates instead of
+ * scanning the whole table, and still yields the same result as the scan.
+ */
+struct DecodeTable {
+    DecodeTable() {
+        for (int key = 0; key < NUM_DECODE_KEYS; key++) {
+            first_candidate[key] = static_cast<u32>(candidates.size());
+            for (int i = 0; i < NUM_ARM_INSTRUCTIONS; i++) {
+                if (IsCandidate(arm_instruction[i], key))
+                    candidates.push_back(static_cast<u8>(i));
+            }
+        }
+        first_candidate[NUM_DECODE_KEYS] = static_cast<u32>(candidates.size());
+    }
+
+    std::array<u32, NUM_DECODE_KEYS + 1> first_candidate;
+    std::vector<u8> candidates;
+};
+
+static_assert(NUM_ARM_INSTRUCTIONS <= 256, "Instruction indices do not fit in the decode table");
+
+} // Anonymous namespace
+
 ARMDecodeStatus DecodeARMInstruction(u32 instr, s32* idx) {
+    static const DecodeTable decode_table;
+
+    const u32 key = GetDecodeKey(instr);
+    for (u32 c = decode_table.first_candidate[key]; c < decode_table.first_candidate[key + 1]; c++) {
+        const int i = decode_table.candidates[c];
+        if (!MatchesEncoding(arm_instruction[i], instr))
+            continue;
+
+        // Some encodings have exceptions that belong to other instructions further down the table
+        if (arm_exclusion_code[i].attribute_value != 0 && MatchesEncoding(arm_exclusion_code[i], instr))
+            continue;
+
+        *idx = i;
+        return ARMDecodeStatus::SUCCESS;
+    }
+    return ARMDecodeStatus::FAILURE;
+}
+
+// This is the original decoder, kept verbatim as the reference the decode table is checked
+// against. It deliberately doesn't share MatchesEncoding with the table.
+ARMDecodeStatus DecodeARMInstructionByScan(u32 instr, s32* idx) {
     int n = 0;
     int base = 0;
     int instr_slots = sizeof(arm_instruction) / sizeof(InstructionSetEncodingItem);
@@ -13,6 +13,12 @@ enum class ARMDecodeStatus {
 
 ARMDecodeStatus DecodeARMInstruction(u32 instr, s32* idx);
 
+/**
+ * Decodes an ARM instruction by testing every entry of arm_instruction in order, which is what
+ * DecodeARMInstruction must be equivalent to. It is much slower and only meant for checking that.
+ */
+ARMDecodeStatus DecodeARMInstructionByScan(u32 instr, s32* idx);
+
 struct InstructionSetEncodingItem {
     const char *name;
     int attribute_value;
@@ -5,19 +5,27 @@
 #define CITRA_IGNORE_EXIT(x)
 
 #include <algorithm>
+#include <array>
 #include <cstdio>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
+#include "common/assert.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/make_unique.h"
 #include "common/microprofile.h"
 #include "common/profiler.h"
 
+#include "core/core_timing.h"
 #include "core/memory.h"
 #include "core/hle/svc.h"
 #include "core/arm/disassembler/arm_disasm.h"
 #include "core/arm/dyncom/arm_dyncom_dec.h"
 #include "core/arm/dyncom/arm_dyncom_interpreter.h"
 #include "core/arm/dyncom/arm_dyncom_thumb.h"
+#include "core/arm/dyncom/arm_dyncom_trans_cache.h"
 #include "core/arm/dyncom/arm_dyncom_run.h"
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/arm/skyeye_common/armsupp.h"
@@ -51,7 +59,84 @@ enum {
 
 typedef unsigned int (*shtop_fp_t)(ARMul_State* cpu, unsigned int sht_oper);
 
-static bool CondPassed(const ARMul_State* cpu, unsigned int cond) {
+// Value of shifter_carry_out when the shifter operand leaves the carry flag unchanged, so that the
+// shifters do not have to compute a lazily evaluated carry flag for every data-processing operand.
+static const unsigned int SHIFTER_CARRY_UNCHANGED = 2;
+
+// The NZCV flags set by data-processing instructions are evaluated lazily: the inputs of the last
+// flag-setting instruction are recorded in the ARMul_State (see LazyFlags), and the flags are only
+// computed when a condition check, an MRS or a CPSR save reads them.
+
+static u32 LazyCarryOut(const ARMul_State* cpu) {
+    return static_cast<u32>((static_cast<u64>(cpu->lazy_operand1) + cpu->lazy_operand2 + cpu->lazy_carry_in) >> 32);
+}
+
+/// Computes any lazily evaluated flags into NFlag, ZFlag, CFlag and VFlag
+static void MaterializeFlags(ARMul_State* cpu) {
+    switch (cpu->lazy_flags) {
+    case LazyFlags::None:
+        return;
+    case LazyFlags::NZCV:
+        cpu->CFlag = LazyCarryOut(cpu);
+        cpu->VFlag = ((cpu->lazy_operand1 ^ cpu->lazy_result) & (cpu->lazy_operand2 ^ cpu->lazy_result)) >> 31;
+        // Fall through
+    case LazyFlags::NZ:
+        cpu->NFlag = cpu->lazy_result >> 31;
+        cpu->ZFlag = cpu->lazy_result == 0;
+        break;
+    }
+    cpu->lazy_flags = LazyFlags::None;
+}
+
+static u32 GetCFlag(const ARMul_State* cpu) {
+    if (cpu->lazy_flags == LazyFlags::NZCV)
+        return LazyCarryOut(cpu);
+    return cpu->CFlag;
+}
+
+/// Sets N and Z from the given result, leaving C and V unchanged
+static void SetNZFlags(ARMul_State* cpu, u32 result) {
+    if (cpu->lazy_flags == LazyFlags::NZCV)
+        MaterializeFlags(cpu);
+
+    cpu->lazy_flags = LazyFlags::NZ;
+    cpu->lazy_result = result;
+}
+
+/// Sets the flags of a logical operation: N and Z from its result, C from the shifter carry out
+static void SetLogicalFlags(ARMul_State* cpu, u32 result) {
+    SetNZFlags(cpu, result);
+    if (cpu->shifter_carry_out != SHIFTER_CARRY_UNCHANGED)
+        cpu->CFlag = cpu->shifter_carry_out;
+}
+
+/// Sets the flags of the addition result = left + right + carry_in, as computed by AddWithCarry
+static void SetAddFlags(ARMul_State* cpu, u32 result, u32 left, u32 right, u32 carry_in) {
+    cpu->lazy_flags = LazyFlags::NZCV;
+    cpu->lazy_result = result;
+    cpu->lazy_operand1 = left;
+    cpu->lazy_operand2 = right;
+    cpu->lazy_carry_in = carry_in;
+}
+
+static bool CondPassed(ARMul_State* cpu, unsigned int cond) {
+    if (cpu->lazy_flags != LazyFlags::None) {
+        // These only depend on the result of the last flag-setting instruction
+        switch (cond) {
+        case ConditionCode::EQ:
+            return cpu->lazy_result == 0;
+        case ConditionCode::NE:
+            return cpu->lazy_result != 0;
+        case ConditionCode::MI:
+            return (cpu->lazy_result >> 31) != 0;
+        case ConditionCode::PL:
+            return (cpu->lazy_result >> 31) == 0;
+        default:
+            MaterializeFlags(cpu);
+            break;
+        }
+    }
+
     const bool n_flag = cpu->NFlag != 0;
     const bool z_flag = cpu->ZFlag != 0;
     const bool c_flag = cpu->CFlag != 0;
@@ -99,7 +184,7 @@ static unsigned int DPO(Immediate)(ARMul_State* cpu, unsigned int sht_oper) {
     unsigned int rotate_imm = BITS(sht_oper, 8, 11);
     unsigned int shifter_operand = ROTATE_RIGHT_32(immed_8, rotate_imm * 2);
     if (rotate_imm == 0)
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     else
         cpu->shifter_carry_out = BIT(shifter_operand, 31);
     return shifter_operand;
@@ -108,7 +193,7 @@ static unsigned int DPO(Immediate)(ARMul_State* cpu, unsigned int sht_oper) {
 static unsigned int DPO(Register)(ARMul_State* cpu, unsigned int sht_oper) {
     unsigned int rm = CHECK_READ_REG15(cpu, RM);
     unsigned int shifter_operand = rm;
-    cpu->shifter_carry_out = cpu->CFlag;
+    cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     return shifter_operand;
 }
 
@@ -118,7 +203,7 @@ static unsigned int DPO(LogicalShiftLeftByImmediate)(ARMul_State* cpu, unsigned
     unsigned int shifter_operand;
     if (shift_imm == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else {
         shifter_operand = rm << shift_imm;
         cpu->shifter_carry_out = BIT(rm, 32 - shift_imm);
@@ -132,7 +217,7 @@ static unsigned int DPO(LogicalShiftLeftByRegister)(ARMul_State* cpu, unsigned i
     unsigned int rs = CHECK_READ_REG15(cpu, RS);
     if (BITS(rs, 0, 7) == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else if (BITS(rs, 0, 7) < 32) {
         shifter_operand = rm << BITS(rs, 0, 7);
         cpu->shifter_carry_out = BIT(rm, 32 - BITS(rs, 0, 7));
@@ -166,7 +251,7 @@ static unsigned int DPO(LogicalShiftRightByRegister)(ARMul_State* cpu, unsigned
     unsigned int shifter_operand;
     if (BITS(rs, 0, 7) == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else if (BITS(rs, 0, 7) < 32) {
         shifter_operand = rm >> BITS(rs, 0, 7);
         cpu->shifter_carry_out = BIT(rm, BITS(rs, 0, 7) - 1);
@@ -203,7 +288,7 @@ static unsigned int DPO(ArithmeticShiftRightByRegister)(ARMul_State* cpu, unsign
     unsigned int shifter_operand;
     if (BITS(rs, 0, 7) == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else if (BITS(rs, 0, 7) < 32) {
         shifter_operand = static_cast<int>(rm) >> BITS(rs, 0, 7);
         cpu->shifter_carry_out = BIT(rm, BITS(rs, 0, 7) - 1);
@@ -222,7 +307,7 @@ static unsigned int DPO(RotateRightByImmediate)(ARMul_State* cpu, unsigned int s
     unsigned int rm = CHECK_READ_REG15(cpu, RM);
     int shift_imm = BITS(sht_oper, 7, 11);
     if (shift_imm == 0) {
-        shifter_operand = (cpu->CFlag << 31) | (rm >> 1);
+        shifter_operand = (GetCFlag(cpu) << 31) | (rm >> 1);
         cpu->shifter_carry_out = BIT(rm, 0);
     } else {
         shifter_operand = ROTATE_RIGHT_32(rm, shift_imm);
@@ -237,7 +322,7 @@ static unsigned int DPO(RotateRightByRegister)(ARMul_State* cpu, unsigned int sh
     unsigned int shifter_operand;
     if (BITS(rs, 0, 7) == 0) {
         shifter_operand = rm;
-        cpu->shifter_carry_out = cpu->CFlag;
+        cpu->shifter_carry_out = SHIFTER_CARRY_UNCHANGED;
     } else if (BITS(rs, 0, 4) == 0) {
         shifter_operand = rm;
         cpu->shifter_carry_out = BIT(rm, 31);
@@ -390,7 +475,7 @@ static void LnSWoUB(ScaledRegisterPreIndexed)(ARMul_State* cpu, unsigned int ins
         break;
     case 3:
         if (shift_imm == 0) {
-            index = (cpu->CFlag << 31) | (rm >> 1);
+            index = (GetCFlag(cpu) << 31) | (rm >> 1);
         } else {
             index = ROTATE_RIGHT_32(rm, shift_imm);
         }
@@ -440,7 +525,7 @@ static void LnSWoUB(ScaledRegisterPostIndexed)(ARMul_State* cpu, unsigned int in
         break;
     case 3:
         if (shift_imm == 0) {
-            index = (cpu->CFlag << 31) | (rm >> 1);
+            index = (GetCFlag(cpu) << 31) | (rm >> 1);
         } else {
             index = ROTATE_RIGHT_32(rm, shift_imm);
         }
@@ -656,7 +741,7 @@ static void LnSWoUB(ScaledRegisterOffset)(ARMul_State* cpu, unsigned int inst, u
         break;
     case 3:
         if (shift_imm == 0) {
-            index = (cpu->CFlag << 31) | (rm >> 1);
+            index = (GetCFlag(cpu) << 31) | (rm >> 1);
         } else {
             index = ROTATE_RIGHT_32(rm, shift_imm);
         }
@@ -678,6 +763,20 @@ struct arm_inst {
     char component[0];
 };
 
+// Cached successor of a block that ends in a direct branch. Once resolved, execution continues
+// straight into the successor instead of going through the instruction cache lookup.
+struct block_link {
+    int target;        // Offset of the successor block in inst_buf, or -1 if not resolved yet
+    unsigned int hits;   // Number of times the link was followed
+    unsigned int misses; // Number of times the successor had to be looked up
+    bool idle_loop;      // Whether the link loops back to the start of an idle loop block
+    // Whether this is the fall-through of a conditional branch ending the block, which is
+    // retranslated as a superblock once the fall-through is hot
+    bool superblock_trigger;
+    u32 block_addr;      // Guest address of the block containing the branch
+    bool side_exit;      // Whether this is the fall-through of a branch inside a superblock
+};
+
 struct generic_arm_inst {
     u32 Ra;
     u32 Rm;
@@ -737,6 +836,8 @@ struct bbl_inst {
     int signed_immed_24;
     unsigned int next_addr;
     unsigned int jmp_addr;
+    block_link taken;
+    block_link not_taken;
 };
 
 struct bx_inst {
@@ -1104,10 +1205,13 @@ struct setend_inst {
 
 struct b_2_thumb {
     unsigned int imm;
+    block_link taken;
 };
 struct b_cond_thumb {
     unsigned int imm;
     unsigned int cond;
+    block_link taken;
+    block_link not_taken;
 };
 
 struct bl_1_thumb {
@@ -1128,21 +1232,170 @@ struct pkh_inst {
     unsigned char imm;
 };
 
+// Data-processing ops with handlers specialised at translation time, see TranslateFastDataProcessing
+enum class FastOp {
+    ADD, SUB, RSB, AND, ORR, EOR, BIC, MOV, MVN, CMP, CMN, TST,
+};
+
+// Listed in the order of FastOp
+#define FAST_DP_OPS(X) X(ADD) X(SUB) X(RSB) X(AND) X(ORR) X(EOR) X(BIC) X(MOV) X(MVN) X(CMP) X(CMN) X(TST)
+
+struct fast_dp_inst {
+    unsigned int Rn;
+    unsigned int Rd;
+    unsigned int operand;   // Value of an immediate operand, or the register of a register operand
+    unsigned int carry_out; // Shifter carry out of an immediate operand, or SHIFTER_CARRY_UNCHANGED
+};
+
 typedef arm_inst * ARM_INST_PTR;
 
 #define CACHE_BUFFER_SIZE    (64 * 1024 * 2000)
+// Upper bound of the space taken by the translation of a single instruction
+#define MAX_INST_SIZE        128
+// Space required to translate a block. Blocks never extend past the end of a page.
+#define MAX_BLOCK_SIZE       ((Memory::PAGE_SIZE / 2) * MAX_INST_SIZE)
+// Space required to translate a superblock, which may extend into the next page
+#define MAX_SUPERBLOCK_SIZE  (2 * MAX_BLOCK_SIZE)
 static char inst_buf[CACHE_BUFFER_SIZE];
 static int top = 0;
+// Incremented every time inst_buf is flushed. Cores holding blocks translated in an older generation
+// discard them before they run again.
+static u32 inst_buf_generation = 0;
+static TranslationDiskCache disk_cache;
 static inline void *AllocBuffer(unsigned int size) {
     int start = top;
     top += size;
-    if (top > CACHE_BUFFER_SIZE) {
-        LOG_ERROR(Core_ARM11, "inst_buf is full");
-        CITRA_IGNORE_EXIT(-1);
-    }
+    ASSERT_MSG(top <= CACHE_BUFFER_SIZE, "inst_buf is full");
     return (void *)&inst_buf[start];
 }
 
+// Switches the given core to the cache of the current address space, and discards its blocks if they
+// belong to a previous generation of inst_buf
+static void SyncInstructionCache(ARMul_State* cpu) {
+    if (cpu->instruction_cache == nullptr || cpu->instruction_cache_page_table != Memory::current_page_table) {
+        std::unique_ptr<InstructionCache>& cache = cpu->instruction_caches[Memory::current_page_table];
+        if (cache == nullptr)
+            cache = Common::make_unique<InstructionCache>();
+        cpu->instruction_cache = cache.get();
+        cpu->instruction_cache_page_table = Memory::current_page_table;
+
+        // The page hashes of the disk cache are those of the previous address space
+        disk_cache.InvalidateAllPages();
+    }
+
+    InstructionCache& cache = *cpu->instruction_cache;
+    if (cache.generation == inst_buf_generation)
+        return;
+
+    cache.blocks.Clear();
+    cache.block_links.clear();
+    cache.superblock_tail_pages.clear();
+    cache.generation = inst_buf_generation;
+}
+
+// Offsets in inst_buf of every block_link, whose counters are logged when inst_buf is flushed
+static std::vector<int> block_link_offsets;
+
+// Logs how often the links of the blocks translated since the last flush were followed, and how often
+// the successor had to be looked up instead
+static void LogBlockLinkStats() {
+    if (block_link_offsets.empty())
+        return;
+
+    struct LinkStats {
+        u64 hits = 0;
+        u64 misses = 0;
+    };
+    std::unordered_map<u32, LinkStats> block_stats;
+    LinkStats total;
+    for (int offset : block_link_offsets) {
+        const block_link* link = reinterpret_cast<const block_link*>(&inst_buf[offset]);
+        LinkStats& stats = block_stats[link->block_addr];
+        stats.hits += link->hits;
+        stats.misses += link->misses;
+        total.hits += link->hits;
+        total.misses += link->misses;
+    }
+
+    const u64 total_branches = total.hits + total.misses;
+    LOG_INFO(Core_ARM11, "Block links of %u blocks: %llu hits, %llu misses (%.1f%% linked)",
+             static_cast<unsigned>(block_stats.size()), static_cast<unsigned long long>(total.hits),
+             static_cast<unsigned long long>(total.misses),
+             total_branches != 0 ? 100.0 * total.hits / total_branches : 0.0);
+
+    // The blocks branching the most often
+    std::vector<std::pair<u32, LinkStats>> sorted_stats(block_stats.begin(), block_stats.end());
+    const size_t num_logged = std::min<size_t>(sorted_stats.size(), 16);
+    std::partial_sort(sorted_stats.begin(), sorted_stats.begin() + num_logged, sorted_stats.end(),
+                      [](const std::pair<u32, LinkStats>& a, const std::pair<u32, LinkStats>& b) {
+                          return a.second.hits + a.second.misses > b.second.hits + b.second.misses;
+                      });
+    for (size_t i = 0; i < num_logged; ++i) {
+        LOG_DEBUG(Core_ARM11, "Block 0x%08X: %llu hits, %llu misses", sorted_stats[i].first,
+                  static_cast<unsigned long long>(sorted_stats[i].second.hits),
+                  static_cast<unsigned long long>(sorted_stats[i].second.misses));
+    }
+}
+
+// Frees all of inst_buf, discarding the translated blocks of every core
+static void FlushInstructionBuffer(ARMul_State* cpu) {
+    LogBlockLinkStats();
+    block_link_offsets.clear();
+
+    top = 0;
+    inst_buf_generation++;
+    SyncInstructionCache(cpu);
+}
+
+static void InitBlockLink(block_link& link) {
+    block_link_offsets.push_back(static_cast<int>(reinterpret_cast<char*>(&link) - inst_buf));
+    link.target = -1;
+    link.hits = 0;
+    link.misses = 0;
+    link.idle_loop = false;
+    link.superblock_trigger = false;
+    link.side_exit = false;
+}
+
+// Resolves a block link to the block at target_addr and records it so that it can be torn down when
+// the page containing that block is invalidated.
+static void LinkBlock(ARMul_State* cpu, block_link* link, u32 target_addr, int target) {
+    link->target = target;
+    cpu->instruction_cache->block_links[target_addr >> Memory::PAGE_BITS].push_back(static_cast<int>(reinterpret_cast<char*>(link) - inst_buf));
+}
+
+static void InvalidateCachePage(InstructionCache& cache, u32 addr) {
+    cache.blocks.InvalidatePage(addr);
+
+    // Superblocks running into this page start in the previous one
+    if (cache.superblock_tail_pages.erase(addr >> Memory::PAGE_BITS) != 0)
+        InvalidateCachePage(cache, addr - Memory::PAGE_SIZE);
+
+    auto links = cache.block_links.find(addr >> Memory::PAGE_BITS);
+    if (links == cache.block_links.end())
+        return;
+
+    for (int offset : links->second)
+        reinterpret_cast<block_link*>(&inst_buf[offset])->target = -1;
+    cache.block_links.erase(links);
+}
+
+void InterpreterInvalidatePage(ARMul_State* cpu, const Memory::PageTable& page_table, u32 addr) {
+    if (&page_table == Memory::current_page_table) {
+        disk_cache.InvalidatePage(addr);
+        // The links of an older generation may point to memory that has been reused since
+        SyncInstructionCache(cpu);
+        InvalidateCachePage(*cpu->instruction_cache, addr);
+        return;
+    }
+
+    // The cache of another address space is only synced once it is switched to, until then it is
+    // left alone if it is from an older generation
+    auto cache = cpu->instruction_caches.find(&page_table);
+    if (cache != cpu->instruction_caches.end() && cache->second->generation == inst_buf_generation)
+        InvalidateCachePage(*cache->second, addr);
+}
+
 static shtop_fp_t get_shtop(unsigned int inst) {
     if (BIT(inst, 25)) {
         return DPO(Immediate);
@@ -1295,6 +1548,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(bbl)(unsigned int inst, int index)
 
     inst_cream->L      = BIT(inst, 24);
     inst_cream->signed_immed_24 = BIT(inst, 23) ? NEGBRANCH : POSBRANCH;
+    InitBlockLink(inst_cream->taken);
+    InitBlockLink(inst_cream->not_taken);
 
     return inst_base;
 }
@@ -3011,6 +3266,7 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_2_thumb)(unsigned int tinst, int ind
     b_2_thumb *inst_cream = (b_2_thumb *)inst_base->component;
 
     inst_cream->imm = ((tinst & 0x3FF) << 1) | ((tinst & (1 << 10)) ? 0xFFFFF800 : 0);
+    InitBlockLink(inst_cream->taken);
 
     inst_base->idx = index;
     inst_base->br  = DIRECT_BRANCH;
@@ -3025,6 +3281,8 @@ static ARM_INST_PTR INTERPRETER_TRANSLATE(b_cond_thumb)(unsigned int tinst, int
 
     inst_cream->imm  = (((tinst & 0x7F) << 1) | ((tinst & (1 << 7)) ?    0xFFFFFF00 : 0));
     inst_cream->cond = ((tinst >> 8) & 0xf);
+    InitBlockLink(inst_cream->taken);
+    InitBlockLink(inst_cream->not_taken);
     inst_base->idx   = index;
     inst_base->br    = DIRECT_BRANCH;
 
@@ -3407,57 +3665,241 @@ const transop_fp_t arm_instruction_trans[] = {
     INTERPRETER_TRANSLATE(blx_1_thumb)
 };
 
-enum {
-    FETCH_SUCCESS,
-    FETCH_FAILURE
-};
+// Index of the first specialised data-processing handler in InstLabel, which comes after the
+// handlers of arm_instruction_trans and the DISPATCH, INIT_INST_LENGTH and END labels
+static const int FAST_DP_BASE = sizeof(arm_instruction_trans) / sizeof(transop_fp_t) + 3;
+
+// Index in InstLabel of the handler specialised for the given op and operand form
+#define FAST_DP_INDEX(op, immediate, set_flags) \
+    (FAST_DP_BASE + static_cast<int>(op) * 4 + (immediate) * 2 + (set_flags))
+
+/// Returns the translator of the given instruction, or null for specialised data-processing handlers
+static transop_fp_t GetTranslator(arm_inst* inst_base) {
+    if (inst_base->idx >= FAST_DP_BASE)
+        return nullptr;
+    return arm_instruction_trans[inst_base->idx];
+}
+
+static bool GetFastOp(transop_fp_t translate, FastOp* op) {
+    static const struct {
+        transop_fp_t translate;
+        FastOp op;
+    } fast_ops[] = {
+        { INTERPRETER_TRANSLATE(add), FastOp::ADD },
+        { INTERPRETER_TRANSLATE(sub), FastOp::SUB },
+        { INTERPRETER_TRANSLATE(rsb), FastOp::RSB },
+        { INTERPRETER_TRANSLATE(and), FastOp::AND },
+        { INTERPRETER_TRANSLATE(orr), FastOp::ORR },
+        { INTERPRETER_TRANSLATE(eor), FastOp::EOR },
+        { INTERPRETER_TRANSLATE(bic), FastOp::BIC },
+        { INTERPRETER_TRANSLATE(mov), FastOp::MOV },
+        { INTERPRETER_TRANSLATE(mvn), FastOp::MVN },
+        { INTERPRETER_TRANSLATE(cmp), FastOp::CMP },
+        { INTERPRETER_TRANSLATE(cmn), FastOp::CMN },
+        { INTERPRETER_TRANSLATE(tst), FastOp::TST },
+    };
 
-static ThumbDecodeStatus DecodeThumbInstruction(u32 inst, u32 addr, u32* arm_inst, u32* inst_size, ARM_INST_PTR* ptr_inst_base) {
-    // Check if in Thumb mode
-    ThumbDecodeStatus ret = TranslateThumbInstruction (addr, inst, arm_inst, inst_size);
-    if (ret == ThumbDecodeStatus::BRANCH) {
-        int inst_index;
-        int table_length = sizeof(arm_instruction_trans) / sizeof(transop_fp_t);
-        u32 tinstr = GetThumbInstruction(inst, addr);
-
-        switch ((tinstr & 0xF800) >> 11) {
-        case 26:
-        case 27:
-            if (((tinstr & 0x0F00) != 0x0E00) && ((tinstr & 0x0F00) != 0x0F00)){
-                inst_index = table_length - 4;
-                *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
-            } else {
-                LOG_ERROR(Core_ARM11, "thumb decoder error");
-            }
-            break;
-        case 28:
-            // Branch 2, unconditional branch
-            inst_index = table_length - 5;
-            *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
-            break;
+    for (const auto& fast_op : fast_ops) {
+        if (fast_op.translate == translate) {
+            *op = fast_op.op;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Translates the most common form of the data-processing instructions to a handler specialised
+ * for the op, the operand form and whether flags are set: unconditional instructions whose operand
+ * is an immediate or an unshifted register and that neither read nor write the PC. Their handlers
+ * skip the condition check, the call to the shifter operand function and the checks for the PC.
+ * @return The translated instruction, or null if it does not have the required form
+ */
+static ARM_INST_PTR TranslateFastDataProcessing(unsigned int inst, int index) {
+    FastOp op;
+    if (BITS(inst, 28, 31) != ConditionCode::AL || !GetFastOp(arm_instruction_trans[index], &op))
+        return nullptr;
+
+    const bool immediate = BIT(inst, 25) != 0;
+    const bool set_flags = BIT(inst, 20) != 0;
+    const bool compare = op == FastOp::CMP || op == FastOp::CMN || op == FastOp::TST;
+    const bool reads_rn = op != FastOp::MOV && op != FastOp::MVN;
+    const unsigned int rn = BITS(inst, 16, 19);
+    const unsigned int rd = BITS(inst, 12, 15);
+    const unsigned int rm = BITS(inst, 0, 3);
+
+    if (!immediate && (BITS(inst, 4, 11) != 0 || rm == 15))
+        return nullptr;
+    if ((reads_rn && rn == 15) || (!compare && rd == 15))
+        return nullptr;
+
+    arm_inst* const inst_base = (arm_inst*)AllocBuffer(sizeof(arm_inst) + sizeof(fast_dp_inst));
+    fast_dp_inst* const inst_cream = (fast_dp_inst*)inst_base->component;
+
+    inst_base->cond = ConditionCode::AL;
+    inst_base->idx  = FAST_DP_INDEX(op, immediate, set_flags);
+    inst_base->br   = NON_BRANCH;
+
+    inst_cream->Rn = reads_rn ? rn : 0;
+    inst_cream->Rd = rd;
+    if (immediate) {
+        const unsigned int immed_8 = BITS(inst, 0, 7);
+        const unsigned int rotate_imm = BITS(inst, 8, 11);
+        if (rotate_imm == 0) {
+            inst_cream->operand = immed_8;
+            inst_cream->carry_out = SHIFTER_CARRY_UNCHANGED;
+        } else {
+            inst_cream->operand = ROTATE_RIGHT_32(immed_8, rotate_imm * 2);
+            inst_cream->carry_out = BIT(inst_cream->operand, 31);
+        }
+    } else {
+        inst_cream->operand = rm;
+        inst_cream->carry_out = SHIFTER_CARRY_UNCHANGED;
+    }
+
+    return inst_base;
+}
+
+/// Runs a data-processing instruction translated by TranslateFastDataProcessing
+template <FastOp op, bool immediate, bool set_flags>
+static inline void ExecuteFastDataProcessing(ARMul_State* cpu, const fast_dp_inst* inst_cream) {
+    const u32 left = cpu->Reg[inst_cream->Rn];
+    const u32 right = immediate ? inst_cream->operand : cpu->Reg[inst_cream->operand];
+
+    u32 result;
+    switch (op) {
+    case FastOp::ADD:
+    case FastOp::CMN:
+        result = left + right;
+        break;
+    case FastOp::SUB:
+    case FastOp::CMP:
+        result = left + ~right + 1;
+        break;
+    case FastOp::RSB:
+        result = ~left + right + 1;
+        break;
+    case FastOp::AND:
+    case FastOp::TST:
+        result = left & right;
+        break;
+    case FastOp::ORR:
+        result = left | right;
+        break;
+    case FastOp::EOR:
+        result = left ^ right;
+        break;
+    case FastOp::BIC:
+        result = left & ~right;
+        break;
+    case FastOp::MOV:
+        result = right;
+        break;
+    case FastOp::MVN:
+        result = ~right;
+        break;
+    }
 
-        case 8:
-        case 29:
-            // For BLX 1 thumb instruction
-            inst_index = table_length - 1;
-            *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
+    if (set_flags) {
+        switch (op) {
+        case FastOp::ADD:
+        case FastOp::CMN:
+            SetAddFlags(cpu, result, left, right, 0);
             break;
-        case 30:
-            // For BL 1 thumb instruction
-            inst_index = table_length - 3;
-            *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
+        case FastOp::SUB:
+        case FastOp::CMP:
+            SetAddFlags(cpu, result, left, ~right, 1);
             break;
-        case 31:
-            // For BL 2 thumb instruction
-            inst_index = table_length - 2;
-            *ptr_inst_base = arm_instruction_trans[inst_index](tinstr, inst_index);
+        case FastOp::RSB:
+            SetAddFlags(cpu, result, ~left, right, 1);
             break;
         default:
-            ret = ThumbDecodeStatus::UNDEFINED;
+            SetNZFlags(cpu, result);
+            if (immediate && inst_cream->carry_out != SHIFTER_CARRY_UNCHANGED)
+                cpu->CFlag = inst_cream->carry_out;
             break;
         }
     }
-    return ret;
+
+    if (op != FastOp::CMP && op != FastOp::CMN && op != FastOp::TST)
+        cpu->Reg[inst_cream->Rd] = result;
+}
+
+enum {
+    FETCH_SUCCESS,
+    FETCH_FAILURE
+};
+
+// Decoding of a 16-bit Thumb instruction, see DecodeThumbInstruction
+struct ThumbDecodeEntry {
+    bool filled;              // Whether the instruction has been decoded yet
+    ThumbDecodeStatus status;
+    u32 inst;                 // Instruction to pass to the translator
+    int idx;                  // Index of the translator in arm_instruction_trans, -1 if there is none
+};
+
+static ThumbDecodeEntry DecodeThumbInstructionUncached(u16 tinstr) {
+    ThumbDecodeEntry entry;
+    entry.filled = true;
+
+    u32 inst_size;
+    entry.status = TranslateThumbInstruction(0, tinstr, &entry.inst, &inst_size);
+    if (entry.status == ThumbDecodeStatus::UNDEFINED) {
+        entry.idx = -1;
+        return entry;
+    }
+    if (entry.status != ThumbDecodeStatus::BRANCH) {
+        // Translated by the translator of the equivalent ARM instruction
+        if (DecodeARMInstruction(entry.inst, &entry.idx) == ARMDecodeStatus::FAILURE)
+            entry.idx = -1;
+        return entry;
+    }
+
+    // The Thumb branches have translators of their own at the end of arm_instruction_trans, which
+    // take the Thumb instruction itself
+    const int table_length = sizeof(arm_instruction_trans) / sizeof(transop_fp_t);
+    entry.inst = tinstr;
+    switch ((tinstr & 0xF800) >> 11) {
+    case 26:
+    case 27:
+        entry.idx = table_length - 4;
+        break;
+    case 28:
+        // Branch 2, unconditional branch
+        entry.idx = table_length - 5;
+        break;
+    case 29:
+        // For BLX 1 thumb instruction
+        entry.idx = table_length - 1;
+        break;
+    case 30:
+        // For BL 1 thumb instruction
+        entry.idx = table_length - 3;
+        break;
+    case 31:
+        // For BL 2 thumb instruction
+        entry.idx = table_length - 2;
+        break;
+    default:
+        entry.status = ThumbDecodeStatus::UNDEFINED;
+        entry.idx = -1;
+        break;
+    }
+    return entry;
+}
+
+/**
+ * Decodes a Thumb instruction to the translator that creates its instruction cream. There are
+ * only 65536 Thumb instructions, so the decoding of each one, which goes through its ARM
+ * equivalent, is done once and then looked up in a table.
+ */
+static const ThumbDecodeEntry& DecodeThumbInstruction(u16 tinstr) {
+    static std::array<ThumbDecodeEntry, 0x10000> thumb_decode_table;
+
+    ThumbDecodeEntry& entry = thumb_decode_table[tinstr];
+    if (!entry.filled)
+        entry = DecodeThumbInstructionUncached(tinstr);
+    return entry;
 }
 
 enum {
@@ -3467,7 +3909,131 @@ enum {
 
 MICROPROFILE_DEFINE(DynCom_Decode, "DynCom", "Decode", MP_RGB(255, 64, 64));
 
-static int InterpreterTranslate(ARMul_State* cpu, int& bb_start, u32 addr) {
+// Maximum number of instructions, not counting the final branch, of a block detected as an idle loop
+static const int MAX_IDLE_LOOP_SIZE = 8;
+
+/**
+ * Checks whether an ARM instruction can be part of an idle loop, ie. a short loop polling memory
+ * that only loads and compares. Such a loop cannot change anything when run again until memory is
+ * written by something else than the loop, which happens at the earliest when a CoreTiming event
+ * fires.
+ * @param read_regs Registers read by the previous instructions of the loop, updated by this call
+ * @param written_regs Registers written by the previous instructions of the loop, updated by this call
+ */
+static bool IsIdleLoopInstruction(u32 inst, u32* read_regs, u32* written_regs) {
+    const u32 rn = BITS(inst, 16, 19);
+    const u32 rd = BITS(inst, 12, 15);
+    const u32 rm = BITS(inst, 0, 3);
+    const u32 rs = BITS(inst, 8, 11);
+
+    if (BITS(inst, 28, 31) == ConditionCode::NV)
+        return false;
+
+    // CMP, CMN, TST and TEQ, which may read registers written by the loads
+    if (BITS(inst, 26, 27) == 0 && BITS(inst, 23, 24) == 2 && BIT(inst, 20)) {
+        if (!BIT(inst, 25) && BIT(inst, 7) && BIT(inst, 4))
+            return false;
+
+        *read_regs |= 1 << rn;
+        if (!BIT(inst, 25)) {
+            *read_regs |= 1 << rm;
+            if (BIT(inst, 4))
+                *read_regs |= 1 << rs;
+        }
+        return true;
+    }
+
+    // Loads without writeback. Their address must not depend on other loads of the loop, and their
+    // destination must not have been read before in the loop, so that every iteration but the first
+    // one does exactly the same.
+    u32 address_regs;
+    if (BITS(inst, 26, 27) == 1 && !(BIT(inst, 25) && BIT(inst, 4))) {
+        // LDR and LDRB
+        address_regs = 1 << rn;
+        if (BIT(inst, 25))
+            address_regs |= 1 << rm;
+    } else if (BITS(inst, 25, 27) == 0 && BIT(inst, 7) && BIT(inst, 4) && BITS(inst, 5, 6) != 0) {
+        // LDRH, LDRSB and LDRSH
+        address_regs = 1 << rn;
+        if (!BIT(inst, 22))
+            address_regs |= 1 << rm;
+    } else {
+        return false;
+    }
+
+    if (!BIT(inst, 20) || !BIT(inst, 24) || BIT(inst, 21) || rd == 15)
+        return false;
+    if ((address_regs & *written_regs) != 0 || (address_regs & (1 << rd)) != 0 || (*read_regs & (1 << rd)) != 0)
+        return false;
+
+    *read_regs |= address_regs;
+    *written_regs |= 1 << rd;
+    return true;
+}
+
+/// Returns the link of the given direct branch if it is taken to target_addr, otherwise null
+static block_link* GetBranchLinkTo(arm_inst* inst_base, u32 branch_addr, u32 target_addr) {
+    const transop_fp_t translate = GetTranslator(inst_base);
+
+    if (translate == INTERPRETER_TRANSLATE(bbl)) {
+        bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
+        if (!inst_cream->L && branch_addr + 8 + inst_cream->signed_immed_24 == target_addr)
+            return &inst_cream->taken;
+    } else if (translate == INTERPRETER_TRANSLATE(b_cond_thumb)) {
+        b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
+        if (branch_addr + 4 + inst_cream->imm == target_addr)
+            return &inst_cream->taken;
+    } else if (translate == INTERPRETER_TRANSLATE(b_2_thumb)) {
+        b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
+        if (branch_addr + 4 + inst_cream->imm == target_addr)
+            return &inst_cream->taken;
+    }
+
+    return nullptr;
+}
+
+/// Returns the fall-through link of a conditional direct branch, otherwise null
+static block_link* GetFallThroughLink(arm_inst* inst_base) {
+    const transop_fp_t translate = GetTranslator(inst_base);
+
+    if (translate == INTERPRETER_TRANSLATE(bbl)) {
+        bbl_inst* inst_cream = (bbl_inst*)inst_base->component;
+        if (!inst_cream->L && inst_base->cond != ConditionCode::AL)
+            return &inst_cream->not_taken;
+    } else if (translate == INTERPRETER_TRANSLATE(b_cond_thumb)) {
+        return &((b_cond_thumb*)inst_base->component)->not_taken;
+    }
+
+    return nullptr;
+}
+
+// Number of times the fall-through of the conditional branch ending a block has to be followed
+// before the block is retranslated as a superblock
+static const unsigned int SUPERBLOCK_THRESHOLD = 256;
+// Maximum number of conditional branches inside a superblock
+static const int MAX_SUPERBLOCK_SIDE_EXITS = 4;
+
+// The translators at the end of arm_instruction_trans take Thumb branches, which are cached as
+// TranslationDiskCache::THUMB_BRANCH, so the indices of ARM instructions have to stay below it.
+static const int NUM_ARM_TRANSLATORS = sizeof(arm_instruction_trans) / sizeof(transop_fp_t) - 5;
+static_assert(NUM_ARM_TRANSLATORS < TranslationDiskCache::THUMB_BRANCH,
+              "Instruction indices overlap the Thumb branch marker of the disk cache");
+
+/**
+ * Translates the basic block starting at the given address.
+ * @param predecoded Decoded instruction indices read from the disk cache. If null, the instructions
+ *                   are decoded and the block is recorded in the disk cache. The indices are checked
+ *                   against the code, and the block is decoded from the first one that doesn't fit.
+ *                   Instructions are always decoded for that, as it is only a table lookup.
+ * @param superblock Whether to translate a superblock, which continues past conditional branches
+ *                   into their fall-through and past the end of the page into the next one. The
+ *                   conditional branches become side exits of the superblock.
+ * @return FETCH_EXCEPTION if the first instruction of the block couldn't be decoded, in which case
+ *         nothing is translated, or KEEP_GOING otherwise. A block ends before any later instruction
+ *         that couldn't be decoded.
+ */
+static int InterpreterTranslate(ARMul_State* cpu, int& bb_start, u32 addr, bool thumb,
+                                const std::vector<u8>* predecoded = nullptr, bool superblock = false) {
     Common::Profiling::ScopeTimer timer_decode(profile_decode);
     MICROPROFILE_SCOPE(DynCom_Decode);
 
@@ -3483,46 +4049,218 @@ static int InterpreterTranslate(ARMul_State* cpu, int& bb_start, u32 addr) {
     bb_start = top;
 
     u32 phys_addr = addr;
-    u32 pc_start = cpu->Reg[15];
+    u32 pc_start = addr;
+
+    // Decoded indices of the block's instructions, to be stored in the disk cache
+    static std::vector<u8> decoded;
+    decoded.clear();
+    bool decode_failed = false;
+    const bool from_disk_cache = predecoded != nullptr;
+
+    Memory::FlagCodePage(pc_start);
+
+    // Idle loop detection, see IsIdleLoopInstruction
+    bool maybe_idle_loop = true;
+    u32 idle_loop_read_regs = 0;
+    u32 idle_loop_written_regs = 0;
+    u32 inst_addr;
+
+    int num_side_exits = 0;
+    bool crossed_page = false;
+    const size_t first_link = block_link_offsets.size();
 
     while (ret == NON_BRANCH) {
+        inst_addr = phys_addr;
         inst = Memory::Read32(phys_addr & 0xFFFFFFFC);
 
         size++;
-        // If we are in Thumb mode, we'll translate one Thumb instruction to the corresponding ARM instruction
-        if (cpu->TFlag) {
-            u32 arm_inst;
-            ThumbDecodeStatus state = DecodeThumbInstruction(inst, phys_addr, &arm_inst, &inst_size, &inst_base);
+        ARMDecodeStatus arm_status = ARMDecodeStatus::SUCCESS;
+        if (thumb) {
+            const ThumbDecodeEntry& thumb_decoded = DecodeThumbInstruction(GetThumbInstruction(inst, phys_addr));
+            inst = thumb_decoded.inst;
+            idx = thumb_decoded.idx;
+            inst_size = 2;
+
+            const int decoded_idx = (thumb_decoded.status == ThumbDecodeStatus::BRANCH)
+                                  ? TranslationDiskCache::THUMB_BRANCH : idx;
+            if (predecoded != nullptr && decoded.size() < predecoded->size() &&
+                (*predecoded)[decoded.size()] != decoded_idx) {
+                LOG_WARNING(Core_ARM11, "Cached Thumb block at 0x%08X doesn't match its code", pc_start);
+                predecoded = nullptr;
+            }
 
-            // We have translated the Thumb branch instruction in the Thumb decoder
-            if (state == ThumbDecodeStatus::BRANCH) {
+            if (thumb_decoded.status == ThumbDecodeStatus::BRANCH) {
+                decoded.push_back(TranslationDiskCache::THUMB_BRANCH);
+                inst_base = arm_instruction_trans[idx](inst, idx);
                 goto translated;
             }
-            inst = arm_inst;
+        } else {
+            // The cached indices are checked against the code too, as a page whose code was written
+            // without going through Memory::Write* is still recorded under the hash of its old code
+            arm_status = DecodeARMInstruction(inst, &idx);
+            if (predecoded != nullptr && decoded.size() < predecoded->size() &&
+                (arm_status == ARMDecodeStatus::FAILURE || (*predecoded)[decoded.size()] != idx)) {
+                LOG_WARNING(Core_ARM11, "Cached ARM block at 0x%08X doesn't match its code", pc_start);
+                predecoded = nullptr;
+            }
         }
 
-        if (DecodeARMInstruction(inst, &idx) == ARMDecodeStatus::FAILURE) {
-            std::string disasm = ARM_Disasm::Disassemble(phys_addr, inst);
-            LOG_ERROR(Core_ARM11, "Decode failure.\tPC : [0x%x]\tInstruction : %s [%x]", phys_addr, disasm.c_str(), inst);
+        if (thumb ? idx == -1 : arm_status == ARMDecodeStatus::FAILURE) {
+            if (thumb) {
+                LOG_ERROR(Core_ARM11, "Decode failure.\tPC : [0x%x]\tThumb instruction : [%x]", phys_addr,
+                          GetThumbInstruction(Memory::Read32(phys_addr & 0xFFFFFFFC), phys_addr));
+            } else {
+                std::string disasm = ARM_Disasm::Disassemble(phys_addr, inst);
+                LOG_ERROR(Core_ARM11, "Decode failure.\tPC : [0x%x]\tInstruction : %s [%x]", phys_addr, disasm.c_str(), inst);
+            }
             LOG_ERROR(Core_ARM11, "cpsr=0x%x, cpu->TFlag=%d, r15=0x%x", cpu->Cpsr, cpu->TFlag, cpu->Reg[15]);
             CITRA_IGNORE_EXIT(-1);
+            decode_failed = true;
+
+            // There is no translator for the instruction, so the block ends right before it. Once
+            // it is reached, translating a block that starts with it fails and stops the core.
+            if (size == 1)
+                return FETCH_EXCEPTION;
+
+            block_link* fall_through = GetFallThroughLink(inst_base);
+            if (fall_through != nullptr && fall_through->side_exit)
+                fall_through->side_exit = false;
+            else
+                inst_base->br = END_OF_PAGE;
+            maybe_idle_loop = false;
+            break;
+        }
+        decoded.push_back(static_cast<u8>(idx));
+        inst_base = TranslateFastDataProcessing(inst, idx);
+        if (inst_base == nullptr)
+            inst_base = arm_instruction_trans[idx](inst, idx);
+
+        if (maybe_idle_loop && inst_base->br == NON_BRANCH) {
+            maybe_idle_loop = size <= MAX_IDLE_LOOP_SIZE &&
+                              IsIdleLoopInstruction(inst, &idle_loop_read_regs, &idle_loop_written_regs);
         }
-        inst_base = arm_instruction_trans[idx](inst, idx);
 
 translated:
         phys_addr += inst_size;
 
         if ((phys_addr & 0xfff) == 0) {
-            inst_base->br = END_OF_PAGE;
+            if (superblock && !crossed_page && Memory::GetPointer(phys_addr) != nullptr) {
+                // Writes to the next page have to invalidate the superblock as well
+                Memory::FlagCodePage(phys_addr);
+                cpu->instruction_cache->superblock_tail_pages.insert(phys_addr >> Memory::PAGE_BITS);
+                crossed_page = true;
+            } else {
+                inst_base->br = END_OF_PAGE;
+            }
         }
         ret = inst_base->br;
+
+        if (superblock && ret != END_OF_PAGE && num_side_exits < MAX_SUPERBLOCK_SIDE_EXITS) {
+            // The fall-through of a side exit is the next instruction of the superblock
+            block_link* fall_through = GetFallThroughLink(inst_base);
+            if (fall_through != nullptr) {
+                fall_through->side_exit = true;
+                num_side_exits++;
+                maybe_idle_loop = false;
+                ret = NON_BRANCH;
+            }
+        }
     };
 
-    cpu->instruction_cache[pc_start] = bb_start;
+    if (maybe_idle_loop) {
+        block_link* loop_link = GetBranchLinkTo(inst_base, inst_addr, pc_start);
+        if (loop_link != nullptr) {
+            LOG_TRACE(Core_ARM11, "Detected idle loop at 0x%08X", pc_start);
+            loop_link->idle_loop = true;
+        }
+    }
+
+    for (size_t i = first_link; i < block_link_offsets.size(); ++i)
+        reinterpret_cast<block_link*>(&inst_buf[block_link_offsets[i]])->block_addr = pc_start;
+
+    if (!superblock) {
+        block_link* fall_through = GetFallThroughLink(inst_base);
+        if (fall_through != nullptr)
+            fall_through->superblock_trigger = true;
+    }
+
+    cpu->instruction_cache->blocks.Insert(pc_start, bb_start);
+
+    // Superblocks are only formed from execution counts, so they are left out of the disk cache
+    if (!from_disk_cache && !decode_failed && !superblock)
+        disk_cache.Record(pc_start, thumb, decoded);
 
     return KEEP_GOING;
 }
 
+/**
+ * Retranslates the block at the given address as a superblock and redirects the links to the old
+ * block to it. The old block stays in inst_buf until the next flush.
+ */
+static void FormSuperblock(ARMul_State* cpu, u32 addr, bool thumb) {
+    const int old_block = cpu->instruction_cache->blocks.Find(addr);
+    if (old_block == -1 || top + MAX_SUPERBLOCK_SIZE > CACHE_BUFFER_SIZE)
+        return;
+
+    int new_block;
+    if (InterpreterTranslate(cpu, new_block, addr, thumb, nullptr, true) == FETCH_EXCEPTION)
+        return;
+    LOG_TRACE(Core_ARM11, "Formed superblock at 0x%08X", addr);
+
+    auto links = cpu->instruction_cache->block_links.find(addr >> Memory::PAGE_BITS);
+    if (links == cpu->instruction_cache->block_links.end())
+        return;
+
+    for (int offset : links->second) {
+        block_link* link = reinterpret_cast<block_link*>(&inst_buf[offset]);
+        if (link->target == old_block)
+            link->target = new_block;
+    }
+}
+
+void InterpreterClearCache(ARMul_State* cpu, const Memory::PageTable& page_table) {
+    // The blocks stay in inst_buf until the next flush, since the core may be running one of them.
+    // The cache in use is emptied rather than destroyed for the same reason.
+    if (cpu->instruction_cache != nullptr && cpu->instruction_cache_page_table == &page_table) {
+        InstructionCache& cache = *cpu->instruction_cache;
+        cache.blocks.Clear();
+        cache.block_links.clear();
+        cache.superblock_tail_pages.clear();
+        disk_cache.InvalidateAllPages();
+        return;
+    }
+    cpu->instruction_caches.erase(&page_table);
+}
+
+void InterpreterLoadTranslationCache(ARMul_State* cpu, u64 program_id) {
+    SyncInstructionCache(cpu);
+
+    if (disk_cache.Open(program_id) == 0)
+        return;
+
+    unsigned int num_translated = 0;
+    for (const CachedBlock& block : disk_cache.LoadValidBlocks()) {
+        if (cpu->instruction_cache->blocks.Find(block.addr) != -1)
+            continue;
+        if (top + MAX_BLOCK_SIZE > CACHE_BUFFER_SIZE)
+            break;
+
+        int bb_start;
+        if (InterpreterTranslate(cpu, bb_start, block.addr, block.thumb, &block.decoded) == KEEP_GOING)
+            num_translated++;
+    }
+
+    LOG_INFO(Core_ARM11, "Translated %u blocks ahead of time", num_translated);
+}
+
+void InterpreterCloseTranslationCache() {
+    disk_cache.Close();
+}
+
+void InterpreterLogBlockLinks() {
+    LogBlockLinkStats();
+}
+
 static int clz(unsigned int x) {
     int n;
     if (x == 0) return (32);
@@ -3565,6 +4303,35 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                        inst_base = (arm_inst *)&inst_buf[ptr]
 
     #define INC_PC(l)   ptr += sizeof(arm_inst) + l
+
+    // Continues directly into the successor block cached in the given block_link if it has been
+    // resolved. Otherwise, or when a breakpoint may have to be looked up for the next block, the
+    // successor is resolved by DISPATCH and stored in the link. Looping back into an idle loop
+    // skips ahead to the next CoreTiming event instead.
+    #define GOTO_LINKED_BLOCK(l) \
+        if ((l).idle_loop) \
+            goto IDLE_LOOP; \
+        if ((l).target != -1 && !GDBStub::g_server_enabled) { \
+            (l).hits++; \
+            ptr = (l).target; \
+            inst_base = (arm_inst *)&inst_buf[ptr]; \
+            GOTO_NEXT_INST; \
+        } \
+        link = &(l); \
+        goto DISPATCH
+    // Continues after a conditional branch that is not taken. Inside a superblock the next
+    // instruction follows the branch, otherwise the block ended by the branch is retranslated as a
+    // superblock once its fall-through is hot.
+    #define GOTO_FALL_THROUGH(l) \
+        if ((l).side_exit) { \
+            inst_base = (arm_inst *)&inst_buf[ptr]; \
+            GOTO_NEXT_INST; \
+        } \
+        if ((l).superblock_trigger && (l).hits == SUPERBLOCK_THRESHOLD) { \
+            (l).superblock_trigger = false; \
+            FormSuperblock(cpu, (l).block_addr, cpu->TFlag != 0); \
+        } \
+        GOTO_LINKED_BLOCK(l)
     #define INC_PC_STUB ptr += sizeof(arm_inst)
 
 #define GDB_BP_CHECK \
@@ -3586,6 +4353,11 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     num_instrs++; \
     goto *InstLabel[inst_base->idx]
 #else
+#define FAST_DP_CASES(op) \
+    case FAST_DP_INDEX(FastOp::op, 0, 0): goto FAST_##op##_0_0; \
+    case FAST_DP_INDEX(FastOp::op, 0, 1): goto FAST_##op##_0_1; \
+    case FAST_DP_INDEX(FastOp::op, 1, 0): goto FAST_##op##_1_0; \
+    case FAST_DP_INDEX(FastOp::op, 1, 1): goto FAST_##op##_1_1;
 #define GOTO_NEXT_INST \
     GDB_BP_CHECK; \
     if (num_instrs >= cpu->NumInstrsToExecute) goto END; \
@@ -3797,14 +4569,14 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     case 203: goto DISPATCH; \
     case 204: goto INIT_INST_LENGTH; \
     case 205: goto END; \
+    FAST_DP_CASES(ADD) FAST_DP_CASES(SUB) FAST_DP_CASES(RSB) FAST_DP_CASES(AND) \
+    FAST_DP_CASES(ORR) FAST_DP_CASES(EOR) FAST_DP_CASES(BIC) FAST_DP_CASES(MOV) \
+    FAST_DP_CASES(MVN) FAST_DP_CASES(CMP) FAST_DP_CASES(CMN) FAST_DP_CASES(TST) \
     }
 #endif
 
-    #define UPDATE_NFLAG(dst)    (cpu->NFlag = BIT(dst, 31) ? 1 : 0)
-    #define UPDATE_ZFLAG(dst)    (cpu->ZFlag = dst ? 0 : 1)
-    #define UPDATE_CFLAG_WITH_SC (cpu->CFlag = cpu->shifter_carry_out)
-
-    #define SAVE_NZCVT cpu->Cpsr = (cpu->Cpsr & 0x0fffffdf) | \
+    #define SAVE_NZCVT MaterializeFlags(cpu); \
+                       cpu->Cpsr = (cpu->Cpsr & 0x0fffffdf) | \
                       (cpu->NFlag << 31) | \
                       (cpu->ZFlag << 30) | \
                       (cpu->CFlag << 29) | \
@@ -3814,7 +4586,8 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                        cpu->ZFlag = (cpu->Cpsr >> 30) & 1; \
                        cpu->CFlag = (cpu->Cpsr >> 29) & 1; \
                        cpu->VFlag = (cpu->Cpsr >> 28) & 1; \
-                       cpu->TFlag = (cpu->Cpsr >> 5) & 1;
+                       cpu->TFlag = (cpu->Cpsr >> 5) & 1; \
+                       cpu->lazy_flags = LazyFlags::None;
 
     #define CurrentModeHasSPSR (cpu->Mode != SYSTEM32MODE) && (cpu->Mode != USER32MODE)
     #define PC (cpu->Reg[15])
@@ -3846,7 +4619,10 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
         &&LDRB_INST,&&STRB_INST,&&LDR_INST,&&LDRCOND_INST, &&STR_INST,&&CDP_INST,&&STC_INST,&&LDC_INST, &&LDREXD_INST,
         &&STREXD_INST,&&LDREXH_INST,&&STREXH_INST, &&NOP_INST, &&YIELD_INST, &&WFE_INST, &&WFI_INST, &&SEV_INST, &&SWI_INST,&&BBL_INST,
         &&B_2_THUMB, &&B_COND_THUMB,&&BL_1_THUMB, &&BL_2_THUMB, &&BLX_1_THUMB, &&DISPATCH,
-        &&INIT_INST_LENGTH,&&END
+        &&INIT_INST_LENGTH,&&END,
+        #define FAST_DP_LABELS(op) &&FAST_##op##_0_0, &&FAST_##op##_0_1, &&FAST_##op##_1_0, &&FAST_##op##_1_1,
+        FAST_DP_OPS(FAST_DP_LABELS)
+        #undef FAST_DP_LABELS
         };
 #endif
     arm_inst* inst_base;
@@ -3854,6 +4630,10 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     unsigned int num_instrs = 0;
 
     int ptr;
+    // Link of the direct branch that ended the previous block, if any
+    block_link* link = nullptr;
+
+    SyncInstructionCache(cpu);
 
     LOAD_NZCVT;
     DISPATCH:
@@ -3870,14 +4650,30 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             cpu->Reg[15] &= 0xfffffffc;
 
         // Find the cached instruction cream, otherwise translate it...
-        auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
-        if (itr != cpu->instruction_cache.end()) {
-            ptr = itr->second;
-        } else {
-            if (InterpreterTranslate(cpu, ptr, cpu->Reg[15]) == FETCH_EXCEPTION)
+        ptr = cpu->instruction_cache->blocks.Find(cpu->Reg[15]);
+        if (ptr == -1) {
+            if (top + MAX_BLOCK_SIZE > CACHE_BUFFER_SIZE) {
+                LOG_DEBUG(Core_ARM11, "inst_buf is full, flushing all translated blocks");
+                FlushInstructionBuffer(cpu);
+                link = nullptr;
+            }
+            if (InterpreterTranslate(cpu, ptr, cpu->Reg[15], cpu->TFlag != 0) == FETCH_EXCEPTION)
                 goto END;
         }
 
+        if (link != nullptr) {
+            link->misses++;
+            // Blocks are left unlinked while profiling so that every block entry is counted here.
+            // Links aren't followed while the GDB stub is enabled, so every branch comes back here
+            // and each link must only be recorded once.
+            if (!cpu->block_profiler && !GDBStub::g_server_enabled && link->target != ptr)
+                LinkBlock(cpu, link, cpu->Reg[15], ptr);
+            link = nullptr;
+        }
+
+        if (cpu->block_profiler)
+            cpu->block_profiler->EnterBlock(cpu->Reg[15], cpu->TFlag != 0, num_instrs);
+
         // Find breakpoint if one exists within the block
         if (GDBStub::g_server_enabled && GDBStub::IsConnected()) {
             breakpoint_data = GDBStub::GetNextBreakpointFromAddress(cpu->Reg[15], GDBStub::BreakpointType::Execute);
@@ -3895,9 +4691,9 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             if (inst_cream->Rn == 15)
                 rn_val += 2 * cpu->GetInstructionSize();
 
-            bool carry;
-            bool overflow;
-            RD = AddWithCarry(rn_val, SHIFTER_OPERAND, cpu->CFlag, &carry, &overflow);
+            const u32 operand = SHIFTER_OPERAND;
+            const u32 carry_in = GetCFlag(cpu);
+            RD = rn_val + operand + carry_in;
 
             if (inst_cream->S && (inst_cream->Rd == 15)) {
                 if (CurrentModeHasSPSR) {
@@ -3906,10 +4702,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                cpu->CFlag = carry;
-                cpu->VFlag = overflow;
+                SetAddFlags(cpu, RD, rn_val, operand, carry_in);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(adc_inst));
@@ -3930,9 +4723,8 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             if (inst_cream->Rn == 15)
                 rn_val += 2 * cpu->GetInstructionSize();
 
-            bool carry;
-            bool overflow;
-            RD = AddWithCarry(rn_val, SHIFTER_OPERAND, 0, &carry, &overflow);
+            const u32 operand = SHIFTER_OPERAND;
+            RD = rn_val + operand;
 
             if (inst_cream->S && (inst_cream->Rd == 15)) {
                 if (CurrentModeHasSPSR) {
@@ -3941,10 +4733,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                cpu->CFlag = carry;
-                cpu->VFlag = overflow;
+                SetAddFlags(cpu, RD, rn_val, operand, 0);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(add_inst));
@@ -3976,9 +4765,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                UPDATE_CFLAG_WITH_SC;
+                SetLogicalFlags(cpu, RD);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(and_inst));
@@ -3992,18 +4779,18 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     }
     BBL_INST:
     {
+        bbl_inst *inst_cream = (bbl_inst *)inst_base->component;
         if ((inst_base->cond == ConditionCode::AL) || CondPassed(cpu, inst_base->cond)) {
-            bbl_inst *inst_cream = (bbl_inst *)inst_base->component;
             if (inst_cream->L) {
                 LINK_RTN_ADDR;
             }
             SET_PC;
             INC_PC(sizeof(bbl_inst));
-            goto DISPATCH;
+            GOTO_LINKED_BLOCK(inst_cream->taken);
         }
         cpu->Reg[15] += cpu->GetInstructionSize();
         INC_PC(sizeof(bbl_inst));
-        goto DISPATCH;
+        GOTO_FALL_THROUGH(inst_cream->not_taken);
     }
     BIC_INST:
     {
@@ -4022,9 +4809,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                UPDATE_CFLAG_WITH_SC;
+                SetLogicalFlags(cpu, RD);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(bic_inst));
@@ -4145,14 +4930,10 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             if (inst_cream->Rn == 15)
                 rn_val += 2 * cpu->GetInstructionSize();
 
-            bool carry;
-            bool overflow;
-            u32 result = AddWithCarry(rn_val, SHIFTER_OPERAND, 0, &carry, &overflow);
+            const u32 operand = SHIFTER_OPERAND;
+            const u32 result = rn_val + operand;
 
-            UPDATE_NFLAG(result);
-            UPDATE_ZFLAG(result);
-            cpu->CFlag = carry;
-            cpu->VFlag = overflow;
+            SetAddFlags(cpu, result, rn_val, operand, 0);
         }
         cpu->Reg[15] += cpu->GetInstructionSize();
         INC_PC(sizeof(cmn_inst));
@@ -4168,14 +4949,10 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             if (inst_cream->Rn == 15)
                 rn_val += 2 * cpu->GetInstructionSize();
 
-            bool carry;
-            bool overflow;
-            u32 result = AddWithCarry(rn_val, ~SHIFTER_OPERAND, 1, &carry, &overflow);
+            const u32 operand = ~SHIFTER_OPERAND;
+            const u32 result = rn_val + operand + 1;
 
-            UPDATE_NFLAG(result);
-            UPDATE_ZFLAG(result);
-            cpu->CFlag = carry;
-            cpu->VFlag = overflow;
+            SetAddFlags(cpu, result, rn_val, operand, 1);
         }
         cpu->Reg[15] += cpu->GetInstructionSize();
         INC_PC(sizeof(cmp_inst));
@@ -4248,9 +5025,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                UPDATE_CFLAG_WITH_SC;
+                SetLogicalFlags(cpu, RD);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(eor_inst));
@@ -4655,8 +5430,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
 
             RD = static_cast<u32>((rm * rs + rn) & 0xffffffff);
             if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
+                SetNZFlags(cpu, RD);
             }
         }
         cpu->Reg[15] += cpu->GetInstructionSize();
@@ -4677,9 +5451,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                UPDATE_CFLAG_WITH_SC;
+                SetLogicalFlags(cpu, RD);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(mov_inst));
@@ -4800,8 +5572,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             u64 rs = RS;
             RD = static_cast<u32>((rm * rs) & 0xffffffff);
             if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
+                SetNZFlags(cpu, RD);
             }
         }
         cpu->Reg[15] += cpu->GetInstructionSize();
@@ -4823,9 +5594,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                UPDATE_CFLAG_WITH_SC;
+                SetLogicalFlags(cpu, RD);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(mvn_inst));
@@ -4857,9 +5626,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                UPDATE_CFLAG_WITH_SC;
+                SetLogicalFlags(cpu, RD);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(orr_inst));
@@ -5107,9 +5874,8 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             if (inst_cream->Rn == 15)
                 rn_val += 2 * cpu->GetInstructionSize();
 
-            bool carry;
-            bool overflow;
-            RD = AddWithCarry(~rn_val, SHIFTER_OPERAND, 1, &carry, &overflow);
+            const u32 operand = SHIFTER_OPERAND;
+            RD = ~rn_val + operand + 1;
 
             if (inst_cream->S && (inst_cream->Rd == 15)) {
                 if (CurrentModeHasSPSR) {
@@ -5118,10 +5884,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                cpu->CFlag = carry;
-                cpu->VFlag = overflow;
+                SetAddFlags(cpu, RD, ~rn_val, operand, 1);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(rsb_inst));
@@ -5142,9 +5905,9 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             if (inst_cream->Rn == 15)
                 rn_val += 2 * cpu->GetInstructionSize();
 
-            bool carry;
-            bool overflow;
-            RD = AddWithCarry(~rn_val, SHIFTER_OPERAND, cpu->CFlag, &carry, &overflow);
+            const u32 operand = SHIFTER_OPERAND;
+            const u32 carry_in = GetCFlag(cpu);
+            RD = ~rn_val + operand + carry_in;
 
             if (inst_cream->S && (inst_cream->Rd == 15)) {
                 if (CurrentModeHasSPSR) {
@@ -5153,10 +5916,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                cpu->CFlag = carry;
-                cpu->VFlag = overflow;
+                SetAddFlags(cpu, RD, ~rn_val, operand, carry_in);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(rsc_inst));
@@ -5286,9 +6046,9 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             if (inst_cream->Rn == 15)
                 rn_val += 2 * cpu->GetInstructionSize();
 
-            bool carry;
-            bool overflow;
-            RD = AddWithCarry(rn_val, ~SHIFTER_OPERAND, cpu->CFlag, &carry, &overflow);
+            const u32 operand = ~SHIFTER_OPERAND;
+            const u32 carry_in = GetCFlag(cpu);
+            RD = rn_val + operand + carry_in;
 
             if (inst_cream->S && (inst_cream->Rd == 15)) {
                 if (CurrentModeHasSPSR) {
@@ -5297,10 +6057,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                cpu->CFlag = carry;
-                cpu->VFlag = overflow;
+                SetAddFlags(cpu, RD, rn_val, operand, carry_in);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(sbc_inst));
@@ -5556,6 +6313,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             RDLO = BITS(rst,  0, 31);
             RDHI = BITS(rst, 32, 63);
             if (inst_cream->S) {
+                MaterializeFlags(cpu);
                 cpu->NFlag = BIT(RDHI, 31);
                 cpu->ZFlag = (RDHI == 0 && RDLO == 0);
             }
@@ -5733,6 +6491,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             RDLO = BITS(rst,  0, 31);
 
             if (inst_cream->S) {
+                MaterializeFlags(cpu);
                 cpu->NFlag = BIT(RDHI, 31);
                 cpu->ZFlag = (RDHI == 0 && RDLO == 0);
             }
@@ -6142,9 +6901,8 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             if (inst_cream->Rn == 15)
                 rn_val += 2 * cpu->GetInstructionSize();
 
-            bool carry;
-            bool overflow;
-            RD = AddWithCarry(rn_val, ~SHIFTER_OPERAND, 1, &carry, &overflow);
+            const u32 operand = ~SHIFTER_OPERAND;
+            RD = rn_val + operand + 1;
 
             if (inst_cream->S && (inst_cream->Rd == 15)) {
                 if (CurrentModeHasSPSR) {
@@ -6153,10 +6911,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
                     LOAD_NZCVT;
                 }
             } else if (inst_cream->S) {
-                UPDATE_NFLAG(RD);
-                UPDATE_ZFLAG(RD);
-                cpu->CFlag = carry;
-                cpu->VFlag = overflow;
+                SetAddFlags(cpu, RD, rn_val, operand, 1);
             }
             if (inst_cream->Rd == 15) {
                 INC_PC(sizeof(sub_inst));
@@ -6289,9 +7044,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
 
             u32 result = lop ^ rop;
 
-            UPDATE_NFLAG(result);
-            UPDATE_ZFLAG(result);
-            UPDATE_CFLAG_WITH_SC;
+            SetLogicalFlags(cpu, result);
         }
         cpu->Reg[15] += cpu->GetInstructionSize();
         INC_PC(sizeof(teq_inst));
@@ -6311,9 +7064,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
 
             u32 result = lop & rop;
 
-            UPDATE_NFLAG(result);
-            UPDATE_ZFLAG(result);
-            UPDATE_CFLAG_WITH_SC;
+            SetLogicalFlags(cpu, result);
         }
         cpu->Reg[15] += cpu->GetInstructionSize();
         INC_PC(sizeof(tst_inst));
@@ -6604,6 +7355,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             RDHI = BITS(rst, 32, 63);
 
             if (inst_cream->S) {
+                MaterializeFlags(cpu);
                 cpu->NFlag = BIT(RDHI, 31);
                 cpu->ZFlag = (RDHI == 0 && RDLO == 0);
             }
@@ -6624,6 +7376,7 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
             RDLO = BITS(rst,  0, 31);
 
             if (inst_cream->S) {
+                MaterializeFlags(cpu);
                 cpu->NFlag = BIT(RDHI, 31);
                 cpu->ZFlag = (RDHI == 0 && RDLO == 0);
             }
@@ -6638,19 +7391,20 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
         b_2_thumb* inst_cream = (b_2_thumb*)inst_base->component;
         cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
         INC_PC(sizeof(b_2_thumb));
-        goto DISPATCH;
+        GOTO_LINKED_BLOCK(inst_cream->taken);
     }
     B_COND_THUMB:
     {
         b_cond_thumb* inst_cream = (b_cond_thumb*)inst_base->component;
 
-        if(CondPassed(cpu, inst_cream->cond))
-            cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
-        else
-            cpu->Reg[15] += 2;
-
         INC_PC(sizeof(b_cond_thumb));
-        goto DISPATCH;
+
+        if (CondPassed(cpu, inst_cream->cond)) {
+            cpu->Reg[15] = cpu->Reg[15] + 4 + inst_cream->imm;
+            GOTO_LINKED_BLOCK(inst_cream->taken);
+        }
+        cpu->Reg[15] += 2;
+        GOTO_FALL_THROUGH(inst_cream->not_taken);
     }
     BL_1_THUMB:
     {
@@ -6902,8 +7656,33 @@ unsigned InterpreterMainLoop(ARMul_State* cpu) {
     #include "core/arm/skyeye_common/vfp/vfpinstr.cpp"
     #undef VFP_INTERPRETER_IMPL
 
+    // Specialised data-processing handlers, one for each combination of FAST_DP_INDEX
+    #define FAST_DP_HANDLER(op, immediate, set_flags) \
+    FAST_##op##_##immediate##_##set_flags: \
+    { \
+        ExecuteFastDataProcessing<FastOp::op, immediate != 0, set_flags != 0>(cpu, (fast_dp_inst*)inst_base->component); \
+        cpu->Reg[15] += cpu->GetInstructionSize(); \
+        INC_PC(sizeof(fast_dp_inst)); \
+        FETCH_INST; \
+        GOTO_NEXT_INST; \
+    }
+    #define FAST_DP_HANDLERS(op) \
+        FAST_DP_HANDLER(op, 0, 0) FAST_DP_HANDLER(op, 0, 1) FAST_DP_HANDLER(op, 1, 0) FAST_DP_HANDLER(op, 1, 1)
+    FAST_DP_OPS(FAST_DP_HANDLERS)
+    #undef FAST_DP_HANDLERS
+    #undef FAST_DP_HANDLER
+
+    IDLE_LOOP:
+    {
+        // The block that was just run polls memory that nothing else can write before the next
+        // CoreTiming event, so there is no point in running it again until then.
+        CoreTiming::Idle();
+        goto END;
+    }
     END:
     {
+        if (cpu->block_profiler)
+            cpu->block_profiler->LeaveBlock(num_instrs);
         SAVE_NZCVT;
         cpu->NumInstrsToExecute = 0;
         return num_instrs;
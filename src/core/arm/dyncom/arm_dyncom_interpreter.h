@@ -4,6 +4,34 @@
 
 #pragma once
 
+#include "common/common_types.h"
+
 struct ARMul_State;
 
+namespace Memory {
+    struct PageTable;
+}
+
 unsigned InterpreterMainLoop(ARMul_State* state);
+
+/**
+ * Discards the blocks translated from the given address space starting in the page containing the
+ * given address, and unlinks all blocks that branch directly into them.
+ */
+void InterpreterInvalidatePage(ARMul_State* state, const Memory::PageTable& page_table, u32 addr);
+
+/// Discards all the blocks translated from the given address space
+void InterpreterClearCache(ARMul_State* state, const Memory::PageTable& page_table);
+
+/**
+ * Opens the translation disk cache of the given program and translates the blocks recorded in it
+ * whose code is unchanged. Blocks translated from then on are recorded in the cache.
+ */
+void InterpreterLoadTranslationCache(ARMul_State* state, u64 program_id);
+
+/// Writes the blocks recorded in the translation disk cache to disk and closes it
+void InterpreterCloseTranslationCache();
+
+/// Logs how often the links between the translated blocks were followed, instead of looking up the
+/// successor block
+void InterpreterLogBlockLinks();
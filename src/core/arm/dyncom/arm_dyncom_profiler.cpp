@@ -0,0 +1,124 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "common/symbols.h"
+
+#include "core/memory.h"
+#include "core/arm/disassembler/arm_disasm.h"
+#include "core/arm/dyncom/arm_dyncom_profiler.h"
+
+// Number of blocks listed in the text report
+static const size_t MAX_REPORTED_BLOCKS = 200;
+// Maximum number of bytes of code kept for each block, to be disassembled in the text report
+static const u32 MAX_CODE_SIZE = 32 * 4;
+
+BlockProfiler::BlockMap::iterator BlockProfiler::AddBlock(u32 key) {
+    BlockInfo block;
+
+    // The code is copied right away because the memory of the process may be gone by the time the
+    // report is written.
+    const u32 addr = key & ~1;
+    const u8* code = Memory::GetPointer(addr);
+    if (code != nullptr) {
+        const u32 size = std::min(MAX_CODE_SIZE, Memory::PAGE_SIZE - (addr & Memory::PAGE_MASK));
+        block.code.assign(code, code + size);
+    }
+
+    return blocks.emplace(key, std::move(block)).first;
+}
+
+void BlockProfiler::Reset() {
+    blocks.clear();
+    current_block = nullptr;
+    current_block_start = 0;
+}
+
+/// Formats the address as an offset into the given symbol containing it, if there is one
+static std::string FormatAddress(const TSymbol& symbol, u32 addr) {
+    if (symbol.name.empty())
+        return "[unknown]";
+    if (symbol.address == addr)
+        return symbol.name;
+    return Common::StringFromFormat("%s+0x%X", symbol.name.c_str(), addr - symbol.address);
+}
+
+void BlockProfiler::WriteReport(const std::string& report_path, const std::string& folded_path) const {
+    std::vector<const BlockMap::value_type*> sorted_blocks;
+    sorted_blocks.reserve(blocks.size());
+    for (const auto& block : blocks)
+        sorted_blocks.push_back(&block);
+    std::sort(sorted_blocks.begin(), sorted_blocks.end(),
+              [](const BlockMap::value_type* a, const BlockMap::value_type* b) {
+                  return a->second.instructions > b->second.instructions;
+              });
+
+    u64 total_instructions = 0;
+    u64 total_entries = 0;
+    for (const auto& block : blocks) {
+        total_instructions += block.second.instructions;
+        total_entries += block.second.entries;
+    }
+
+    std::string report = Common::StringFromFormat(
+        "%u blocks, %llu block entries, %llu instructions\n\n", static_cast<unsigned>(sorted_blocks.size()),
+        static_cast<unsigned long long>(total_entries), static_cast<unsigned long long>(total_instructions));
+    std::string folded;
+
+    for (size_t i = 0; i < sorted_blocks.size(); ++i) {
+        const bool thumb = (sorted_blocks[i]->first & 1) != 0;
+        const u32 addr = sorted_blocks[i]->first & ~1;
+        const BlockInfo& block = sorted_blocks[i]->second;
+        const TSymbol symbol = Symbols::GetContainingSymbol(addr);
+
+        // Blocks are stacked on top of the function containing them
+        folded += Common::StringFromFormat("%s;0x%08X %llu\n", symbol.name.empty() ? "[unknown]" : symbol.name.c_str(),
+                                           addr, static_cast<unsigned long long>(block.instructions));
+
+        if (i >= MAX_REPORTED_BLOCKS)
+            continue;
+
+        const double percentage = total_instructions != 0 ? 100.0 * block.instructions / total_instructions : 0.0;
+        report += Common::StringFromFormat("#%u 0x%08X%s %s: %llu instructions (%.2f%%), %llu entries\n",
+                                           static_cast<unsigned>(i + 1), addr, thumb ? " (Thumb)" : "",
+                                           FormatAddress(symbol, addr).c_str(), static_cast<unsigned long long>(block.instructions),
+                                           percentage, static_cast<unsigned long long>(block.entries));
+
+        // The blocks are only known by their start address, so disassemble as many instructions as
+        // are executed on average per entry.
+        const u64 num_instructions = block.entries != 0 ? (block.instructions + block.entries - 1) / block.entries : 0;
+        const u32 inst_size = thumb ? 2 : 4;
+        for (u32 offset = 0; offset + inst_size <= block.code.size() && offset / inst_size < num_instructions; offset += inst_size) {
+            const u32 inst_addr = addr + offset;
+
+            if (thumb) {
+                // The disassembler only handles ARM code
+                u16 inst;
+                std::memcpy(&inst, &block.code[offset], sizeof(inst));
+                report += Common::StringFromFormat("    %08X: %04X\n", inst_addr, inst);
+            } else {
+                u32 inst;
+                std::memcpy(&inst, &block.code[offset], sizeof(inst));
+                report += Common::StringFromFormat("    %08X: %08X  %s\n", inst_addr, inst,
+                                                   ARM_Disasm::Disassemble(inst_addr, inst).c_str());
+            }
+        }
+        report += '\n';
+    }
+
+    if (!FileUtil::CreateFullPath(report_path) || !FileUtil::CreateFullPath(folded_path) ||
+        FileUtil::WriteStringToFile(true, report, report_path.c_str()) != report.size() ||
+        FileUtil::WriteStringToFile(true, folded, folded_path.c_str()) != folded.size()) {
+        LOG_ERROR(Core_ARM11, "Failed to write the block profile to %s", report_path.c_str());
+        return;
+    }
+
+    LOG_INFO(Core_ARM11, "Wrote the block profile to %s and %s", report_path.c_str(), folded_path.c_str());
+}
@@ -0,0 +1,81 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+
+/**
+ * Counts how often each translated block of the dyncom interpreter is entered and how many
+ * instructions are executed in it, keyed by the guest address of the block.
+ *
+ * The interpreter calls EnterBlock whenever it dispatches to a block. Block linking is disabled
+ * while a profiler is attached so that every block entry goes through the dispatcher.
+ */
+class BlockProfiler {
+public:
+    /**
+     * Records the entry into the block at the given address. The instructions executed since the
+     * previous call are attributed to the previously entered block.
+     * @param num_instrs Number of instructions executed so far in the current interpreter run
+     */
+    void EnterBlock(u32 addr, bool thumb, unsigned num_instrs) {
+        LeaveBlock(num_instrs);
+
+        const u32 key = addr | (thumb ? 1 : 0);
+        auto block = blocks.find(key);
+        if (block == blocks.end())
+            block = AddBlock(key);
+
+        current_block = &block->second;
+        current_block->entries++;
+        current_block_start = num_instrs;
+    }
+
+    /// Records the end of an interpreter run, which leaves the current block
+    void LeaveBlock(unsigned num_instrs) {
+        if (current_block == nullptr)
+            return;
+
+        current_block->instructions += num_instrs - current_block_start;
+        current_block = nullptr;
+    }
+
+    /// Discards all the collected counts
+    void Reset();
+
+    bool IsEmpty() const {
+        return blocks.empty();
+    }
+
+    /**
+     * Writes the collected counts to the given files.
+     * @param report_path Path of a text report of the hottest blocks, sorted by executed instructions,
+     *                    with the symbol containing each block and its disassembly
+     * @param folded_path Path of a file in the folded stacks format read by flamegraph.pl, with one
+     *                    "symbol;block count" line per block
+     */
+    void WriteReport(const std::string& report_path, const std::string& folded_path) const;
+
+private:
+    struct BlockInfo {
+        u64 entries = 0;
+        u64 instructions = 0;
+        /// Copy of the code at the start of the block when it was first entered, for the report
+        std::vector<u8> code;
+    };
+    using BlockMap = std::unordered_map<u32, BlockInfo>;
+
+    BlockMap::iterator AddBlock(u32 key);
+
+    /// Every block entered so far, keyed by guest address with the lowest bit set for Thumb blocks
+    BlockMap blocks;
+
+    BlockInfo* current_block = nullptr;
+    unsigned current_block_start = 0;
+};
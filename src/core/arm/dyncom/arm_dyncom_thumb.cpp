@@ -299,9 +299,13 @@ ThumbDecodeStatus TranslateThumbInstruction(u32 addr, u32 instr, u32* ainstr, u3
                 0xE6FF0FB0, // REVSH
             };
 
-            *ainstr = subset[BITS(tinstr, 6, 7)] // base
-                | (BITS(tinstr, 0, 2) << 12)     // Rd
-                | BITS(tinstr, 3, 5);            // Rm
+            if (BITS(tinstr, 6, 7) == 3) {
+                valid = ThumbDecodeStatus::UNDEFINED;
+            } else {
+                *ainstr = subset[BITS(tinstr, 6, 7)] // base
+                    | (BITS(tinstr, 0, 2) << 12)     // Rd
+                    | BITS(tinstr, 3, 5);            // Rm
+            }
         } else {
             static const u32 subset[4] = {
                 0xE92D0000, // STMDB sp!,{rlist}
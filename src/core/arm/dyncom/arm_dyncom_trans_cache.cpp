@@ -0,0 +1,150 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+
+#include "core/memory.h"
+#include "core/arm/dyncom/arm_dyncom_trans_cache.h"
+
+const u8 TranslationDiskCache::THUMB_BRANCH;
+const u32 TranslationDiskCache::MAX_FILE_SIZE;
+
+/// Size taken in the cache file by an entry with the given number of decoded instructions
+static u32 GetEntrySize(size_t num_decoded) {
+    // The value size and the entry number surround the key and the value
+    return static_cast<u32>(2 * sizeof(u32) + sizeof(TranslationCacheKey) + num_decoded);
+}
+
+/**
+ * Computes the hash of the contents of the guest page containing the given address.
+ * @return false if the page is not backed by memory
+ */
+static bool HashPage(u32 addr, u64* hash) {
+    const u8* page = Memory::GetPointer(addr & ~Memory::PAGE_MASK);
+    if (page == nullptr)
+        return false;
+
+    *hash = Common::ComputeHash64(page, Memory::PAGE_SIZE);
+    return true;
+}
+
+u32 TranslationDiskCache::Open(u64 program_id) {
+    Close();
+
+    const std::string dir = FileUtil::GetUserPath(D_CACHE_IDX) + "dyncom" DIR_SEP;
+    if (!FileUtil::CreateFullPath(dir)) {
+        LOG_ERROR(Core_ARM11, "Failed to create translation cache directory %s", dir.c_str());
+        return 0;
+    }
+
+    filename = dir + Common::StringFromFormat("%016llX.bin", program_id);
+    file_size = 0;
+    const u32 num_entries = file.OpenAndRead(filename.c_str(), *this);
+    is_open = true;
+
+    LOG_INFO(Core_ARM11, "Loaded %u blocks from translation cache %s", num_entries, filename.c_str());
+    return num_entries;
+}
+
+void TranslationDiskCache::Close() {
+    if (!is_open)
+        return;
+
+    file.Sync();
+    file.Close();
+    is_open = false;
+
+    recorded_keys.clear();
+    loaded_blocks.clear();
+    page_hashes.clear();
+}
+
+void TranslationDiskCache::Read(const TranslationCacheKey& key, const u8* value, u32 value_size) {
+    file_size += GetEntrySize(value_size);
+    if (recorded_keys.insert(key).second)
+        loaded_blocks.emplace_back(key, std::vector<u8>(value, value + value_size));
+}
+
+bool TranslationDiskCache::GetPageHash(u32 addr, u64* hash) {
+    const u32 page = addr >> Memory::PAGE_BITS;
+    auto it = page_hashes.find(page);
+    if (it != page_hashes.end()) {
+        *hash = it->second;
+        return true;
+    }
+
+    if (!HashPage(addr, hash))
+        return false;
+    page_hashes.emplace(page, *hash);
+    return true;
+}
+
+void TranslationDiskCache::Append(const TranslationCacheKey& key, const std::vector<u8>& decoded) {
+    file.Append(key, decoded.data(), static_cast<u32>(decoded.size()));
+    file_size += GetEntrySize(decoded.size());
+}
+
+std::vector<CachedBlock> TranslationDiskCache::LoadValidBlocks() {
+    std::vector<CachedBlock> blocks;
+    std::vector<TranslationCacheKey> keys;
+
+    for (const auto& entry : loaded_blocks) {
+        const TranslationCacheKey& key = entry.first;
+        u64 page_hash;
+        if (GetPageHash(key.addr, &page_hash) && page_hash == key.page_hash) {
+            blocks.push_back({ key.addr, key.thumb != 0, entry.second });
+            keys.push_back(key);
+        }
+    }
+    loaded_blocks.clear();
+
+    // The pages are only known to hold translated code, which keeps their hashes up to date, once
+    // the blocks have been translated
+    page_hashes.clear();
+
+    if (is_open && file_size > MAX_FILE_SIZE / 2) {
+        LOG_INFO(Core_ARM11, "Rewriting translation cache %s with its %zu valid blocks",
+                 filename.c_str(), blocks.size());
+
+        file.Close();
+        FileUtil::Delete(filename);
+        file_size = 0;
+        file.OpenAndRead(filename.c_str(), *this);
+
+        recorded_keys.clear();
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            recorded_keys.insert(keys[i]);
+            Append(keys[i], blocks[i].decoded);
+        }
+        file.Sync();
+    }
+
+    return blocks;
+}
+
+void TranslationDiskCache::Record(u32 addr, bool thumb, const std::vector<u8>& decoded) {
+    if (!is_open || decoded.empty() || file_size >= MAX_FILE_SIZE)
+        return;
+
+    TranslationCacheKey key;
+    if (!GetPageHash(addr, &key.page_hash))
+        return;
+    key.addr = addr;
+    key.thumb = thumb;
+
+    if (recorded_keys.insert(key).second)
+        Append(key, decoded);
+}
+
+void TranslationDiskCache::InvalidatePage(u32 addr) {
+    page_hashes.erase(addr >> Memory::PAGE_BITS);
+}
+
+void TranslationDiskCache::InvalidateAllPages() {
+    page_hashes.clear();
+}
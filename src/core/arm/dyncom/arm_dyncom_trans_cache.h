@@ -0,0 +1,109 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/linear_disk_cache.h"
+
+/// Disk cache key of a translated block
+struct TranslationCacheKey {
+    u64 page_hash; ///< Hash of the contents of the guest page containing the block
+    u32 addr;      ///< Guest address of the first instruction of the block
+    u32 thumb;     ///< Whether the block was translated as Thumb code
+
+    bool operator<(const TranslationCacheKey& other) const {
+        return std::tie(page_hash, addr, thumb) < std::tie(other.page_hash, other.addr, other.thumb);
+    }
+};
+
+/// A block read from the disk cache
+struct CachedBlock {
+    u32 addr;
+    bool thumb;
+    /// Decoded arm_instruction index of every instruction in the block, see TranslationDiskCache
+    std::vector<u8> decoded;
+};
+
+/**
+ * Stores the decoding results of translated dyncom blocks on disk, so that the blocks of a title
+ * can be translated ahead of time when it is launched again. Entries are keyed by a hash of the guest
+ * page holding the block, which keeps them from being used once the code has changed.
+ * The file is rewritten from scratch when it was written by a different build, and with only the
+ * blocks that are still valid when it has grown past half of MAX_FILE_SIZE. Blocks are no longer
+ * recorded once it reaches MAX_FILE_SIZE.
+ */
+class TranslationDiskCache : private LinearDiskCacheReader<TranslationCacheKey, u8> {
+public:
+    /// Marks a Thumb branch, which is decoded by the Thumb decoder rather than through an index
+    static const u8 THUMB_BRANCH = 0xFF;
+    /// Size in bytes the cache file is not allowed to grow past
+    static const u32 MAX_FILE_SIZE = 32 * 1024 * 1024;
+
+    /**
+     * Opens the cache file of the given program, closing the previously opened one.
+     * @return Number of blocks read from the file
+     */
+    u32 Open(u64 program_id);
+
+    /// Closes the cache file, writing any pending entries to disk
+    void Close();
+
+    bool IsOpen() const {
+        return is_open;
+    }
+
+    /**
+     * Gets the blocks read from the cache file whose guest page still has the contents they were
+     * decoded from. If the file has grown past half of MAX_FILE_SIZE, it is rewritten with only
+     * these blocks.
+     */
+    std::vector<CachedBlock> LoadValidBlocks();
+
+    /**
+     * Appends a translated block to the cache file if it has not been recorded already.
+     * @param addr Guest address of the first instruction of the block
+     * @param thumb Whether the block was translated as Thumb code
+     * @param decoded Decoded index of every instruction of the block
+     */
+    void Record(u32 addr, bool thumb, const std::vector<u8>& decoded);
+
+    /// Forgets the hash of the given guest page, which has to be called when its contents change
+    void InvalidatePage(u32 addr);
+
+    /// Forgets the hashes of all guest pages, when another address space becomes current
+    void InvalidateAllPages();
+
+private:
+    void Read(const TranslationCacheKey& key, const u8* value, u32 value_size) override;
+
+    /// Gets the hash of the guest page containing the given address, hashing it if it isn't cached
+    bool GetPageHash(u32 addr, u64* hash);
+
+    /// Adds an entry to the cache file
+    void Append(const TranslationCacheKey& key, const std::vector<u8>& decoded);
+
+    LinearDiskCache<TranslationCacheKey, u8> file;
+    std::string filename;
+    bool is_open = false;
+    /// Size of the entries of the cache file in bytes
+    u32 file_size = 0;
+
+    /**
+     * Hashes of the guest pages holding recorded blocks, by page number. Those pages hold translated
+     * code, so any write to them invalidates it, which drops their hash through InvalidatePage.
+     */
+    std::unordered_map<u32, u64> page_hashes;
+
+    /// Keys of all the blocks in the cache file
+    std::set<TranslationCacheKey> recorded_keys;
+    /// Blocks read from the cache file when it was opened
+    std::vector<std::pair<TranslationCacheKey, std::vector<u8>>> loaded_blocks;
+};
@@ -0,0 +1,165 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+
+#include "common/make_unique.h"
+
+#include "core/arm/skyeye_common/armstate.h"
+
+#include "core/arm/dyncom/arm_dyncom_interpreter.h"
+#include "core/arm/jit_x64/arm_jit_x64.h"
+#include "core/arm/jit_x64/jit_compiler.h"
+
+#include "core/core.h"
+#include "core/core_timing.h"
+
+#include "core/gdbstub/gdbstub.h"
+
+ARM_JitX64::ARM_JitX64(PrivilegeMode initial_mode) {
+    state = Common::make_unique<ARMul_State>(initial_mode);
+    compiler = Common::make_unique<JitX64::JitCompiler>(state.get());
+}
+
+ARM_JitX64::~ARM_JitX64() {
+    InterpreterCloseTranslationCache();
+}
+
+void ARM_JitX64::SetPC(u32 pc) {
+    state->Reg[15] = pc;
+}
+
+u32 ARM_JitX64::GetPC() const {
+    return state->Reg[15];
+}
+
+u32 ARM_JitX64::GetReg(int index) const {
+    return state->Reg[index];
+}
+
+void ARM_JitX64::SetReg(int index, u32 value) {
+    state->Reg[index] = value;
+}
+
+u32 ARM_JitX64::GetVFPReg(int index) const {
+    return state->ExtReg[index];
+}
+
+void ARM_JitX64::SetVFPReg(int index, u32 value) {
+    state->ExtReg[index] = value;
+}
+
+u32 ARM_JitX64::GetVFPSystemReg(VFPSystemRegister reg) const {
+    return state->VFP[reg];
+}
+
+void ARM_JitX64::SetVFPSystemReg(VFPSystemRegister reg, u32 value) {
+    state->VFP[reg] = value;
+}
+
+u32 ARM_JitX64::GetCPSR() const {
+    return state->Cpsr;
+}
+
+void ARM_JitX64::SetCPSR(u32 cpsr) {
+    state->Cpsr = cpsr;
+}
+
+u32 ARM_JitX64::GetCP15Register(CP15Register reg) {
+    return state->CP15[reg];
+}
+
+void ARM_JitX64::SetCP15Register(CP15Register reg, u32 value) {
+    state->CP15[reg] = value;
+}
+
+void ARM_JitX64::AddTicks(u64 ticks) {
+    down_count -= ticks;
+    if (down_count < 0)
+        CoreTiming::Advance();
+}
+
+void ARM_JitX64::ExecuteInstructions(int num_instructions) {
+    reschedule_pending = false;
+
+    // Breakpoints are only checked by the interpreter, so let it run everything while debugging
+    if (GDBStub::g_server_enabled) {
+        state->NumInstrsToExecute = num_instructions;
+        AddTicks(InterpreterMainLoop(state.get()));
+        return;
+    }
+
+    // Like dyncom, execution only stops between blocks, so more instructions than requested may be
+    // executed.
+    unsigned ticks_executed = 0;
+    while (ticks_executed < static_cast<unsigned>(num_instructions) && !reschedule_pending) {
+        if (state->Cpsr & TBIT) {
+            // Thumb code is not recompiled
+            state->NumInstrsToExecute = num_instructions - ticks_executed;
+            ticks_executed += InterpreterMainLoop(state.get());
+            continue;
+        }
+
+        state->Reg[15] &= 0xFFFFFFFC;
+        ticks_executed += compiler->GetBlock(state->Reg[15])(state.get());
+    }
+
+    AddTicks(ticks_executed);
+}
+
+void ARM_JitX64::ResetContext(Core::ThreadContext& context, u32 stack_top, u32 entry_point, u32 arg) {
+    memset(&context, 0, sizeof(Core::ThreadContext));
+
+    context.cpu_registers[0] = arg;
+    context.pc = entry_point;
+    context.sp = stack_top;
+    context.cpsr = 0x1F; // Usermode
+}
+
+void ARM_JitX64::SaveContext(Core::ThreadContext& ctx) {
+    memcpy(ctx.cpu_registers, state->Reg.data(), sizeof(ctx.cpu_registers));
+    memcpy(ctx.fpu_registers, state->ExtReg.data(), sizeof(ctx.fpu_registers));
+
+    ctx.sp = state->Reg[13];
+    ctx.lr = state->Reg[14];
+    ctx.pc = state->Reg[15];
+    ctx.cpsr = state->Cpsr;
+
+    ctx.fpscr = state->VFP[1];
+    ctx.fpexc = state->VFP[2];
+}
+
+void ARM_JitX64::LoadContext(const Core::ThreadContext& ctx) {
+    memcpy(state->Reg.data(), ctx.cpu_registers, sizeof(ctx.cpu_registers));
+    memcpy(state->ExtReg.data(), ctx.fpu_registers, sizeof(ctx.fpu_registers));
+
+    state->Reg[13] = ctx.sp;
+    state->Reg[14] = ctx.lr;
+    state->Reg[15] = ctx.pc;
+    state->Cpsr = ctx.cpsr;
+
+    state->VFP[1] = ctx.fpscr;
+    state->VFP[2] = ctx.fpexc;
+}
+
+void ARM_JitX64::PrepareReschedule() {
+    state->NumInstrsToExecute = 0;
+    reschedule_pending = true;
+}
+
+void ARM_JitX64::InvalidateCodePage(const Memory::PageTable& page_table, u32 addr) {
+    compiler->InvalidatePage(page_table, addr);
+    InterpreterInvalidatePage(state.get(), page_table, addr);
+}
+
+void ARM_JitX64::ClearInstructionCache(const Memory::PageTable& page_table) {
+    compiler->ClearCache(page_table);
+    InterpreterClearCache(state.get(), page_table);
+}
+
+void ARM_JitX64::LoadTranslationCache(u64 program_id) {
+    // Only the blocks of the interpreter, which runs the code the recompiler does not handle, are
+    // cached on disk.
+    InterpreterLoadTranslationCache(state.get(), program_id);
+}
@@ -0,0 +1,64 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+
+#include "common/common_types.h"
+
+#include "core/arm/arm_interface.h"
+#include "core/arm/skyeye_common/arm_regformat.h"
+#include "core/arm/skyeye_common/armstate.h"
+
+namespace Core {
+struct ThreadContext;
+}
+
+namespace JitX64 {
+class JitCompiler;
+}
+
+/**
+ * ARM11 core which recompiles guest ARM-mode basic blocks to x86_64 code. Instructions the
+ * recompiler does not handle, as well as Thumb code, are executed by the dyncom interpreter on the
+ * same ARMul_State.
+ */
+class ARM_JitX64 final : virtual public ARM_Interface {
+public:
+    ARM_JitX64(PrivilegeMode initial_mode);
+    ~ARM_JitX64();
+
+    void SetPC(u32 pc) override;
+    u32 GetPC() const override;
+    u32 GetReg(int index) const override;
+    void SetReg(int index, u32 value) override;
+    u32 GetVFPReg(int index) const override;
+    void SetVFPReg(int index, u32 value) override;
+    u32 GetVFPSystemReg(VFPSystemRegister reg) const override;
+    void SetVFPSystemReg(VFPSystemRegister reg, u32 value) override;
+    u32 GetCPSR() const override;
+    void SetCPSR(u32 cpsr) override;
+    u32 GetCP15Register(CP15Register reg) override;
+    void SetCP15Register(CP15Register reg, u32 value) override;
+
+    void AddTicks(u64 ticks) override;
+
+    void ResetContext(Core::ThreadContext& context, u32 stack_top, u32 entry_point, u32 arg) override;
+    void SaveContext(Core::ThreadContext& ctx) override;
+    void LoadContext(const Core::ThreadContext& ctx) override;
+
+    void PrepareReschedule() override;
+    void InvalidateCodePage(const Memory::PageTable& page_table, u32 addr) override;
+    void ClearInstructionCache(const Memory::PageTable& page_table) override;
+    void LoadTranslationCache(u64 program_id) override;
+    void ExecuteInstructions(int num_instructions) override;
+
+private:
+    std::unique_ptr<ARMul_State> state;
+    std::unique_ptr<JitX64::JitCompiler> compiler;
+
+    /// Set by PrepareReschedule to stop executing blocks
+    bool reschedule_pending = false;
+};
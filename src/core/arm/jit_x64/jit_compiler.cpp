@@ -0,0 +1,688 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstddef>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/make_unique.h"
+#include "common/string_util.h"
+#include "common/x64/abi.h"
+#include "common/x64/emitter.h"
+
+#include "core/memory.h"
+#include "core/arm/dyncom/arm_dyncom_interpreter.h"
+#include "core/arm/jit_x64/jit_compiler.h"
+#include "core/arm/skyeye_common/armstate.h"
+#include "core/arm/skyeye_common/armsupp.h"
+
+namespace JitX64 {
+
+using namespace Gen;
+
+// The following is used to alias some commonly used registers. RAX, RCX, RDX, R8 and R9 are used as
+// scratch registers within a compiler function and are not preserved across guest instructions.
+// All guest state lives in the ARMul_State instance, so no host register holds guest state between
+// instructions.
+
+/// Pointer to the ARMul_State instance the block is executed on
+static const X64Reg STATE = Gen::R15;
+
+/// Size of the code space reserved for compiled blocks
+static const int CODE_SPACE_SIZE = 32 * 1024 * 1024;
+/// Minimum amount of free code space required to start compiling a new block
+static const size_t MIN_FREE_CODE_SPACE = 256 * 1024;
+/// Maximum number of instructions handed to the interpreter at once when falling back
+static const u32 MAX_INTERPRETED_RUN = 32;
+
+/// Data processing opcodes (bits [24:21])
+enum class DataProcessingOp : u32 {
+    AND = 0, EOR = 1, SUB = 2, RSB = 3, ADD = 4, ADC = 5, SBC = 6, RSC = 7,
+    TST = 8, TEQ = 9, CMP = 10, CMN = 11, ORR = 12, MOV = 13, BIC = 14, MVN = 15,
+};
+
+static bool IsLogicalOp(DataProcessingOp op) {
+    switch (op) {
+    case DataProcessingOp::AND:
+    case DataProcessingOp::EOR:
+    case DataProcessingOp::TST:
+    case DataProcessingOp::TEQ:
+    case DataProcessingOp::ORR:
+    case DataProcessingOp::MOV:
+    case DataProcessingOp::BIC:
+    case DataProcessingOp::MVN:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool IsComparisonOp(DataProcessingOp op) {
+    return op >= DataProcessingOp::TST && op <= DataProcessingOp::CMN;
+}
+
+static bool IsBranchInstruction(u32 inst) {
+    return BITS(inst, 28, 31) != ConditionCode::NV && BITS(inst, 25, 27) == 5;
+}
+
+static bool IsCompilableDataProcessing(u32 inst) {
+    const auto op = static_cast<DataProcessingOp>(BITS(inst, 21, 24));
+    const bool s = BIT(inst, 20) != 0;
+
+    // Register-shifted operands share their encoding space with multiplies and extra load/stores
+    if (!BIT(inst, 25) && BIT(inst, 4))
+        return false;
+    // Comparisons without the S bit encode MRS, MSR, BX and other miscellaneous instructions
+    if (IsComparisonOp(op) && !s)
+        return false;
+    // Writes to the PC are branches and are left to the interpreter
+    if (BITS(inst, 12, 15) == 15)
+        return false;
+    return true;
+}
+
+static bool IsCompilableLoadStore(u32 inst) {
+    const bool register_offset = BIT(inst, 25) != 0;
+    const bool p = BIT(inst, 24) != 0;
+    const bool w = BIT(inst, 21) != 0;
+    const bool l = BIT(inst, 20) != 0;
+    const u32 rn = BITS(inst, 16, 19);
+    const u32 rd = BITS(inst, 12, 15);
+
+    // Register-shifted-by-register forms are media instructions
+    if (register_offset && BIT(inst, 4))
+        return false;
+    // LDRT/STRT/LDRBT/STRBT
+    if (!p && w)
+        return false;
+    // Loads into the PC are branches
+    if (l && rd == 15)
+        return false;
+    // Unpredictable writeback forms
+    if ((!p || w) && (rn == 15 || (l && rn == rd)))
+        return false;
+    if (register_offset && BITS(inst, 0, 3) == 15)
+        return false;
+    return true;
+}
+
+static bool IsCompilable(u32 inst) {
+    if (BITS(inst, 28, 31) == ConditionCode::NV)
+        return false;
+
+    switch (BITS(inst, 26, 27)) {
+    case 0:
+        return IsCompilableDataProcessing(inst);
+    case 1:
+        return IsCompilableLoadStore(inst);
+    default:
+        return IsBranchInstruction(inst);
+    }
+}
+
+/**
+ * Returns a mask with bit N set if the given condition code passes for the NZCV value N, where N
+ * is the value of CPSR bits [31:28].
+ */
+static u32 ConditionPassMask(u32 cond) {
+    u32 mask = 0;
+    for (u32 nzcv = 0; nzcv < 16; ++nzcv) {
+        const bool n = (nzcv & 8) != 0;
+        const bool z = (nzcv & 4) != 0;
+        const bool c = (nzcv & 2) != 0;
+        const bool v = (nzcv & 1) != 0;
+
+        bool passed;
+        switch (cond) {
+        case ConditionCode::EQ: passed = z; break;
+        case ConditionCode::NE: passed = !z; break;
+        case ConditionCode::CS: passed = c; break;
+        case ConditionCode::CC: passed = !c; break;
+        case ConditionCode::MI: passed = n; break;
+        case ConditionCode::PL: passed = !n; break;
+        case ConditionCode::VS: passed = v; break;
+        case ConditionCode::VC: passed = !v; break;
+        case ConditionCode::HI: passed = c && !z; break;
+        case ConditionCode::LS: passed = !c || z; break;
+        case ConditionCode::GE: passed = n == v; break;
+        case ConditionCode::LT: passed = n != v; break;
+        case ConditionCode::GT: passed = !z && n == v; break;
+        case ConditionCode::LE: passed = z || n != v; break;
+        default: passed = true; break;
+        }
+
+        if (passed)
+            mask |= 1 << nzcv;
+    }
+    return mask;
+}
+
+// Thunks called from compiled code. These go through ARMul_State so that memory breakpoints and
+// the endianness of the guest are handled the same way as in the interpreter. Loads from regular
+// memory only fall back to them when the inline page table lookup fails.
+
+static u32 ReadMemory8(ARMul_State* state, u32 addr) {
+    return state->ReadMemory8(addr);
+}
+
+static u32 ReadMemory32(ARMul_State* state, u32 addr) {
+    return state->ReadMemory32(addr);
+}
+
+static void WriteMemory8(ARMul_State* state, u32 addr, u32 value) {
+    state->WriteMemory8(addr, static_cast<u8>(value));
+}
+
+static void WriteMemory32(ARMul_State* state, u32 addr, u32 value) {
+    state->WriteMemory32(addr, value);
+}
+
+static u32 RunInterpreter(ARMul_State* state, u32 num_instructions) {
+    state->NumInstrsToExecute = num_instructions;
+    return InterpreterMainLoop(state);
+}
+
+JitCompiler::JitCompiler(ARMul_State* state)
+        : state(state), block_cache(nullptr), block_cache_page_table(nullptr) {
+    AllocCodeSpace(CODE_SPACE_SIZE);
+}
+
+int JitCompiler::RegOffset(int reg) const {
+    return static_cast<int>(reinterpret_cast<const u8*>(&state->Reg[reg]) - reinterpret_cast<const u8*>(state));
+}
+
+int JitCompiler::CpsrOffset() const {
+    return static_cast<int>(reinterpret_cast<const u8*>(&state->Cpsr) - reinterpret_cast<const u8*>(state));
+}
+
+void JitCompiler::SelectBlockCache() {
+    std::unique_ptr<BlockCache>& cache = block_caches[Memory::current_page_table];
+    if (cache == nullptr)
+        cache = Common::make_unique<BlockCache>(nullptr);
+    block_cache = cache.get();
+    block_cache_page_table = Memory::current_page_table;
+}
+
+CompiledBlock* JitCompiler::GetBlock(u32 addr) {
+    if (block_cache == nullptr || block_cache_page_table != Memory::current_page_table)
+        SelectBlockCache();
+
+    CompiledBlock* block = block_cache->Find(addr);
+    if (block != nullptr)
+        return block;
+
+    block = Compile(addr);
+    block_cache->Insert(addr, block);
+    return block;
+}
+
+void JitCompiler::ClearCache() {
+    // The code space is shared by all address spaces
+    for (auto& cache : block_caches)
+        cache.second->Clear();
+    ClearCodeSpace();
+}
+
+// The code of the blocks discarded below stays allocated until the next flush, since one of them
+// may still be executing.
+
+void JitCompiler::ClearCache(const Memory::PageTable& page_table) {
+    auto cache = block_caches.find(&page_table);
+    if (cache == block_caches.end())
+        return;
+
+    if (cache->second.get() == block_cache) {
+        block_cache->Clear();
+    } else {
+        block_caches.erase(cache);
+    }
+}
+
+void JitCompiler::InvalidatePage(const Memory::PageTable& page_table, u32 addr) {
+    auto cache = block_caches.find(&page_table);
+    if (cache != block_caches.end())
+        cache->second->InvalidatePage(addr);
+}
+
+CompiledBlock* JitCompiler::Compile(u32 addr) {
+    if (GetSpaceLeft() < MIN_FREE_CODE_SPACE) {
+        LOG_DEBUG(Core_ARM11, "Code space exhausted, flushing all blocks");
+        ClearCache();
+    }
+
+    Memory::FlagCodePage(addr);
+
+    const u8* start = AlignCode16();
+
+    // The stack pointer is 8 modulo 16 at the entry of a procedure
+    ABI_PushRegistersAndAdjustStack({STATE}, 8);
+    MOV(PTRBITS, R(STATE), R(ABI_PARAM1));
+
+    u32 pc = addr;
+    u32 num_instructions = 0;
+
+    while (true) {
+        const u32 inst = Memory::Read32(pc);
+
+        if (IsBranchInstruction(inst)) {
+            Compile_Branch(pc, inst, num_instructions + 1);
+            break;
+        }
+
+        if (!IsCompilable(inst) || !Compile_Instruction(pc, inst)) {
+            // Hand a run of consecutive uncompilable instructions to the interpreter. The run is
+            // only a heuristic: the interpreter follows guest control flow on its own, so
+            // stopping it early or late is harmless.
+            u32 run = 1;
+            while (run < MAX_INTERPRETED_RUN) {
+                const u32 next_pc = pc + run * 4;
+                if ((next_pc & Memory::PAGE_MASK) == 0)
+                    break;
+                const u32 next_inst = Memory::Read32(next_pc);
+                if (IsCompilable(next_inst))
+                    break;
+                run++;
+            }
+
+            Compile_Interpret(pc, run, num_instructions);
+            break;
+        }
+
+        num_instructions++;
+        pc += 4;
+
+        // Blocks never cross a guest page, like the interpreter's translation blocks
+        if ((pc & Memory::PAGE_MASK) == 0) {
+            Compile_Return(pc, num_instructions);
+            break;
+        }
+    }
+
+    RegisterCode(start, Common::StringFromFormat("ARM_0x%08X", addr));
+    return (CompiledBlock*)start;
+}
+
+bool JitCompiler::Compile_Instruction(u32 pc, u32 inst) {
+    switch (BITS(inst, 26, 27)) {
+    case 0:
+        return Compile_DataProcessing(pc, inst);
+    case 1:
+        return Compile_LoadStore(pc, inst);
+    default:
+        return false;
+    }
+}
+
+FixupBranch JitCompiler::Compile_ConditionCheck(u32 inst) {
+    MOV(32, R(EAX), MDisp(STATE, CpsrOffset()));
+    SHR(32, R(EAX), Imm8(28));
+    MOV(32, R(ECX), Imm32(ConditionPassMask(BITS(inst, 28, 31))));
+    BT(32, R(ECX), R(EAX));
+    return J_CC(CC_NC, true);
+}
+
+void JitCompiler::Compile_LoadReg(X64Reg dest, int reg, u32 pc) {
+    if (reg == 15) {
+        MOV(32, R(dest), Imm32(pc + 8));
+    } else {
+        MOV(32, R(dest), MDisp(STATE, RegOffset(reg)));
+    }
+}
+
+bool JitCompiler::Compile_ShifterOperand(u32 pc, u32 inst, bool carry_out) {
+    const u32 rm = BITS(inst, 0, 3);
+    const u32 shift_imm = BITS(inst, 7, 11);
+
+    Compile_LoadReg(ECX, rm, pc);
+
+    switch (BITS(inst, 5, 6)) {
+    case 0: // LSL
+        if (shift_imm == 0)
+            return false;
+        if (carry_out) {
+            MOV(32, R(EDX), R(ECX));
+            SHR(32, R(EDX), Imm8(32 - shift_imm));
+            AND(32, R(EDX), Imm32(1));
+        }
+        SHL(32, R(ECX), Imm8(shift_imm));
+        return true;
+
+    case 1: // LSR
+        if (shift_imm == 0) {
+            // LSR #32
+            if (carry_out) {
+                MOV(32, R(EDX), R(ECX));
+                SHR(32, R(EDX), Imm8(31));
+            }
+            XOR(32, R(ECX), R(ECX));
+        } else {
+            if (carry_out) {
+                MOV(32, R(EDX), R(ECX));
+                SHR(32, R(EDX), Imm8(shift_imm - 1));
+                AND(32, R(EDX), Imm32(1));
+            }
+            SHR(32, R(ECX), Imm8(shift_imm));
+        }
+        return true;
+
+    case 2: // ASR
+        if (shift_imm == 0) {
+            // ASR #32
+            SAR(32, R(ECX), Imm8(31));
+            if (carry_out) {
+                MOV(32, R(EDX), R(ECX));
+                AND(32, R(EDX), Imm32(1));
+            }
+        } else {
+            if (carry_out) {
+                MOV(32, R(EDX), R(ECX));
+                SHR(32, R(EDX), Imm8(shift_imm - 1));
+                AND(32, R(EDX), Imm32(1));
+            }
+            SAR(32, R(ECX), Imm8(shift_imm));
+        }
+        return true;
+
+    case 3: // ROR
+        if (shift_imm == 0) {
+            // RRX
+            if (carry_out) {
+                MOV(32, R(EDX), R(ECX));
+                AND(32, R(EDX), Imm32(1));
+            }
+            MOV(32, R(Gen::R8), MDisp(STATE, CpsrOffset()));
+            AND(32, R(Gen::R8), Imm32(CBIT));
+            SHL(32, R(Gen::R8), Imm8(2));
+            SHR(32, R(ECX), Imm8(1));
+            OR(32, R(ECX), R(Gen::R8));
+        } else {
+            ROR(32, R(ECX), Imm8(shift_imm));
+            if (carry_out) {
+                MOV(32, R(EDX), R(ECX));
+                SHR(32, R(EDX), Imm8(31));
+            }
+        }
+        return true;
+    }
+
+    UNREACHABLE();
+}
+
+void JitCompiler::Compile_UpdateFlags(X64Reg carry, bool overflow) {
+    u32 preserved = ~(NBIT | ZBIT);
+
+    // N
+    MOV(32, R(Gen::R8), R(EAX));
+    AND(32, R(Gen::R8), Imm32(NBIT));
+
+    // Z: the compare sets the carry only if EAX is zero, which SBB turns into an all-ones mask
+    CMP(32, R(EAX), Imm32(1));
+    SBB(32, R(Gen::R9), R(Gen::R9));
+    AND(32, R(Gen::R9), Imm32(ZBIT));
+    OR(32, R(Gen::R8), R(Gen::R9));
+
+    if (overflow) {
+        // ECX holds the overflow flag as 0 or 1, stored by the caller with SETO
+        SHL(32, R(ECX), Imm8(28));
+        OR(32, R(Gen::R8), R(ECX));
+        preserved &= ~VBIT;
+    }
+
+    if (carry != INVALID_REG) {
+        SHL(32, R(carry), Imm8(29));
+        OR(32, R(Gen::R8), R(carry));
+        preserved &= ~CBIT;
+    }
+
+    AND(32, MDisp(STATE, CpsrOffset()), Imm32(preserved));
+    OR(32, MDisp(STATE, CpsrOffset()), R(Gen::R8));
+}
+
+bool JitCompiler::Compile_DataProcessing(u32 pc, u32 inst) {
+    const auto op = static_cast<DataProcessingOp>(BITS(inst, 21, 24));
+    const bool s = BIT(inst, 20) != 0;
+    const u32 rn = BITS(inst, 16, 19);
+    const u32 rd = BITS(inst, 12, 15);
+
+    const bool conditional = BITS(inst, 28, 31) != ConditionCode::AL;
+    FixupBranch skip;
+    if (conditional)
+        skip = Compile_ConditionCheck(inst);
+
+    const bool logical = IsLogicalOp(op);
+    const bool need_carry = s && logical;
+
+    // Operand 2 goes into ECX, the shifter carry out (if any) into EDX
+    bool carry_valid;
+    if (BIT(inst, 25)) {
+        const u32 rotate = BITS(inst, 8, 11) * 2;
+        const u32 imm = rotate ? (BITS(inst, 0, 7) >> rotate) | (BITS(inst, 0, 7) << (32 - rotate)) : BITS(inst, 0, 7);
+        MOV(32, R(ECX), Imm32(imm));
+        carry_valid = rotate != 0;
+        if (need_carry && carry_valid)
+            MOV(32, R(EDX), Imm32(imm >> 31));
+    } else {
+        carry_valid = Compile_ShifterOperand(pc, inst, need_carry);
+    }
+
+    // The result is computed into EAX. Arithmetic operations leave the x86 flags live and set
+    // `carry_cc` to the x86 condition matching the ARM carry flag.
+    CCFlags carry_cc = CC_C;
+    switch (op) {
+    case DataProcessingOp::AND:
+    case DataProcessingOp::TST:
+        Compile_LoadReg(EAX, rn, pc);
+        AND(32, R(EAX), R(ECX));
+        break;
+    case DataProcessingOp::EOR:
+    case DataProcessingOp::TEQ:
+        Compile_LoadReg(EAX, rn, pc);
+        XOR(32, R(EAX), R(ECX));
+        break;
+    case DataProcessingOp::ORR:
+        Compile_LoadReg(EAX, rn, pc);
+        OR(32, R(EAX), R(ECX));
+        break;
+    case DataProcessingOp::BIC:
+        Compile_LoadReg(EAX, rn, pc);
+        NOT(32, R(ECX));
+        AND(32, R(EAX), R(ECX));
+        break;
+    case DataProcessingOp::MOV:
+        MOV(32, R(EAX), R(ECX));
+        break;
+    case DataProcessingOp::MVN:
+        MOV(32, R(EAX), R(ECX));
+        NOT(32, R(EAX));
+        break;
+    case DataProcessingOp::ADD:
+    case DataProcessingOp::CMN:
+        Compile_LoadReg(EAX, rn, pc);
+        ADD(32, R(EAX), R(ECX));
+        break;
+    case DataProcessingOp::ADC:
+        Compile_LoadReg(EAX, rn, pc);
+        BT(32, MDisp(STATE, CpsrOffset()), Imm8(29));
+        ADC(32, R(EAX), R(ECX));
+        break;
+    case DataProcessingOp::SUB:
+    case DataProcessingOp::CMP:
+        Compile_LoadReg(EAX, rn, pc);
+        SUB(32, R(EAX), R(ECX));
+        carry_cc = CC_NC;
+        break;
+    case DataProcessingOp::SBC:
+        Compile_LoadReg(EAX, rn, pc);
+        BT(32, MDisp(STATE, CpsrOffset()), Imm8(29));
+        CMC();
+        SBB(32, R(EAX), R(ECX));
+        carry_cc = CC_NC;
+        break;
+    case DataProcessingOp::RSB:
+        Compile_LoadReg(EDX, rn, pc);
+        MOV(32, R(EAX), R(ECX));
+        SUB(32, R(EAX), R(EDX));
+        carry_cc = CC_NC;
+        break;
+    case DataProcessingOp::RSC:
+        Compile_LoadReg(EDX, rn, pc);
+        MOV(32, R(EAX), R(ECX));
+        BT(32, MDisp(STATE, CpsrOffset()), Imm8(29));
+        CMC();
+        SBB(32, R(EAX), R(EDX));
+        carry_cc = CC_NC;
+        break;
+    }
+
+    if (s) {
+        if (logical) {
+            Compile_UpdateFlags(carry_valid ? EDX : INVALID_REG, false);
+        } else {
+            SETcc(carry_cc, R(EDX));
+            SETcc(CC_O, R(ECX));
+            MOVZX(32, 8, EDX, R(EDX));
+            MOVZX(32, 8, ECX, R(ECX));
+            Compile_UpdateFlags(EDX, true);
+        }
+    }
+
+    if (!IsComparisonOp(op))
+        MOV(32, MDisp(STATE, RegOffset(rd)), R(EAX));
+
+    if (conditional)
+        SetJumpTarget(skip);
+
+    return true;
+}
+
+bool JitCompiler::Compile_LoadStore(u32 pc, u32 inst) {
+    const bool register_offset = BIT(inst, 25) != 0;
+    const bool p = BIT(inst, 24) != 0;
+    const bool u = BIT(inst, 23) != 0;
+    const bool b = BIT(inst, 22) != 0;
+    const bool w = BIT(inst, 21) != 0;
+    const bool l = BIT(inst, 20) != 0;
+    const u32 rn = BITS(inst, 16, 19);
+    const u32 rd = BITS(inst, 12, 15);
+
+    const bool conditional = BITS(inst, 28, 31) != ConditionCode::AL;
+    FixupBranch skip;
+    if (conditional)
+        skip = Compile_ConditionCheck(inst);
+
+    // The offset goes into ECX for register offsets
+    if (register_offset)
+        Compile_ShifterOperand(pc, inst, false);
+
+    // Base address into EAX. As in the interpreter, PC-relative accesses use the word-aligned PC,
+    // which is always aligned in ARM mode.
+    Compile_LoadReg(EAX, rn, pc);
+
+    // EDX is used as the updated base register for post-indexed addressing
+    X64Reg updated_base = EAX;
+    if (!p) {
+        MOV(32, R(EDX), R(EAX));
+        updated_base = EDX;
+    }
+
+    if (register_offset) {
+        if (u) {
+            ADD(32, R(updated_base), R(ECX));
+        } else {
+            SUB(32, R(updated_base), R(ECX));
+        }
+    } else if (BITS(inst, 0, 11) != 0) {
+        if (u) {
+            ADD(32, R(updated_base), Imm32(BITS(inst, 0, 11)));
+        } else {
+            SUB(32, R(updated_base), Imm32(BITS(inst, 0, 11)));
+        }
+    }
+
+    // Writeback happens before the access, matching the interpreter's addressing mode helpers
+    if (!p || w)
+        MOV(32, MDisp(STATE, RegOffset(rn)), R(updated_base));
+
+    if (l) {
+        // Loads from regular memory read straight through the current page table. Unmapped and I/O
+        // pages, as well as big endian mode, take the slow path through the memory thunks.
+        MOV(32, R(ECX), R(EAX));
+        SHR(32, R(ECX), Imm8(Memory::PAGE_BITS));
+        MOV(64, R(RDX), ImmPtr(&Memory::current_page_table));
+        MOV(64, R(RDX), MatR(RDX));
+        MOV(64, R(RDX), MComplex(RDX, RCX, SCALE_8, offsetof(Memory::PageTable, pointers)));
+        TEST(64, R(RDX), R(RDX));
+        FixupBranch unmapped = J_CC(CC_Z);
+        TEST(32, MDisp(STATE, CpsrOffset()), Imm32(1 << 9));
+        FixupBranch big_endian = J_CC(CC_NZ);
+
+        AND(32, R(EAX), Imm32(Memory::PAGE_MASK));
+        if (b) {
+            MOVZX(32, 8, ECX, MRegSum(RDX, RAX));
+        } else {
+            MOV(32, R(ECX), MRegSum(RDX, RAX));
+        }
+        MOV(32, MDisp(STATE, RegOffset(rd)), R(ECX));
+        FixupBranch done = J();
+
+        SetJumpTarget(unmapped);
+        SetJumpTarget(big_endian);
+        MOV(32, R(ABI_PARAM2), R(EAX));
+        MOV(PTRBITS, R(ABI_PARAM1), R(STATE));
+        ABI_CallFunction(b ? (const void*)&ReadMemory8 : (const void*)&ReadMemory32);
+        MOV(32, MDisp(STATE, RegOffset(rd)), R(ABI_RETURN));
+        SetJumpTarget(done);
+    } else {
+        // Stores always go through the thunks so that writes to translated code are tracked
+        MOV(32, R(ABI_PARAM2), R(EAX));
+        Compile_LoadReg(ABI_PARAM3, rd, pc);
+        MOV(PTRBITS, R(ABI_PARAM1), R(STATE));
+        ABI_CallFunction(b ? (const void*)&WriteMemory8 : (const void*)&WriteMemory32);
+    }
+
+    if (conditional)
+        SetJumpTarget(skip);
+
+    return true;
+}
+
+void JitCompiler::Compile_Branch(u32 pc, u32 inst, u32 num_instructions) {
+    const u32 offset = static_cast<u32>(static_cast<s32>(inst << 8) >> 6);
+    const u32 target = pc + 8 + offset;
+    const bool link = BIT(inst, 24) != 0;
+
+    const bool conditional = BITS(inst, 28, 31) != ConditionCode::AL;
+    FixupBranch skip;
+    if (conditional)
+        skip = Compile_ConditionCheck(inst);
+
+    if (link)
+        MOV(32, MDisp(STATE, RegOffset(14)), Imm32(pc + 4));
+    Compile_Return(target, num_instructions);
+
+    if (conditional) {
+        SetJumpTarget(skip);
+        Compile_Return(pc + 4, num_instructions);
+    }
+}
+
+void JitCompiler::Compile_Return(u32 next_pc, u32 num_instructions) {
+    MOV(32, MDisp(STATE, RegOffset(15)), Imm32(next_pc));
+    MOV(32, R(ABI_RETURN), Imm32(num_instructions));
+    ABI_PopRegistersAndAdjustStack({STATE}, 8);
+    RET();
+}
+
+void JitCompiler::Compile_Interpret(u32 pc, u32 count, u32 num_instructions) {
+    MOV(32, MDisp(STATE, RegOffset(15)), Imm32(pc));
+    MOV(PTRBITS, R(ABI_PARAM1), R(STATE));
+    MOV(32, R(ABI_PARAM2), Imm32(count));
+    ABI_CallFunction((const void*)&RunInterpreter);
+    if (num_instructions != 0)
+        ADD(32, R(ABI_RETURN), Imm32(num_instructions));
+    ABI_PopRegistersAndAdjustStack({STATE}, 8);
+    RET();
+}
+
+} // namespace JitX64
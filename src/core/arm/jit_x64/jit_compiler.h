@@ -0,0 +1,112 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "common/common_types.h"
+#include "common/x64/emitter.h"
+
+#include "core/arm/block_table.h"
+
+struct ARMul_State;
+
+namespace JitX64 {
+
+/**
+ * Signature of a compiled guest basic block. The block executes starting at the current PC of the
+ * given state, leaves the PC pointing to the next instruction to execute and returns the number of
+ * guest instructions that were executed.
+ */
+using CompiledBlock = u32(ARMul_State* state);
+
+/**
+ * This class implements a basic block recompiler for the ARM11. Guest ARM-mode basic blocks are
+ * translated into x86_64 code operating directly on an ARMul_State. Instructions which are not
+ * handled by the recompiler are executed by the dyncom interpreter, which always terminates the
+ * compiled block they appear in.
+ */
+class JitCompiler : public Gen::XCodeBlock {
+public:
+    explicit JitCompiler(ARMul_State* state);
+
+    /**
+     * Gets the compiled code for the ARM-mode basic block starting at the given address, compiling
+     * it first if necessary.
+     * @param addr Guest address of the first instruction of the block
+     * @return Pointer to the compiled block
+     */
+    CompiledBlock* GetBlock(u32 addr);
+
+    /// Discards all compiled blocks
+    void ClearCache();
+
+    /// Discards the blocks compiled from the given address space
+    void ClearCache(const Memory::PageTable& page_table);
+
+    /**
+     * Discards the blocks compiled from the given address space starting in the guest page
+     * containing the given address
+     */
+    void InvalidatePage(const Memory::PageTable& page_table, u32 addr);
+
+private:
+    using BlockCache = BlockTable<CompiledBlock*>;
+
+    /// Makes the block cache of the current address space the one blocks are looked up in
+    void SelectBlockCache();
+
+    CompiledBlock* Compile(u32 addr);
+
+    /**
+     * Attempts to compile a single guest instruction.
+     * @return true if the instruction was compiled, false if it has to be interpreted
+     */
+    bool Compile_Instruction(u32 pc, u32 inst);
+    bool Compile_DataProcessing(u32 pc, u32 inst);
+    bool Compile_LoadStore(u32 pc, u32 inst);
+    void Compile_Branch(u32 pc, u32 inst, u32 num_instructions);
+
+    /// Emits a conditional jump that is taken when the condition code of `inst` fails
+    Gen::FixupBranch Compile_ConditionCheck(u32 inst);
+
+    /**
+     * Loads the shifter operand of a data processing or load/store instruction into ECX. If
+     * `carry_out` is set, the shifter carry out is loaded into EDX as 0 or 1.
+     * @return false if the carry flag is unaffected by the shift (EDX is not written)
+     */
+    bool Compile_ShifterOperand(u32 pc, u32 inst, bool carry_out);
+
+    /// Loads a guest register into a host register, applying the PC read offset for R15
+    void Compile_LoadReg(Gen::X64Reg dest, int reg, u32 pc);
+
+    /**
+     * Updates the NZCV bits of the guest CPSR. N and Z are computed from EAX. If `carry` is not
+     * INVALID_REG, it holds the new C flag as 0 or 1, and if `overflow` is set the V flag is taken
+     * from ECX, which the caller must have set to 0 or 1 with SETO. The host flags themselves are
+     * clobbered.
+     */
+    void Compile_UpdateFlags(Gen::X64Reg carry, bool overflow);
+
+    /// Emits the epilogue of a block, storing `next_pc` and returning the instruction count
+    void Compile_Return(u32 next_pc, u32 num_instructions);
+
+    /// Emits a call to the interpreter for `count` instructions, which terminates the block
+    void Compile_Interpret(u32 pc, u32 count, u32 num_instructions);
+
+    int RegOffset(int reg) const;
+    int CpsrOffset() const;
+
+    ARMul_State* state;
+
+    /// Compiled blocks of every address space the core has run code from, keyed by its page table
+    std::unordered_map<const Memory::PageTable*, std::unique_ptr<BlockCache>> block_caches;
+    /// Cache of the address space of block_cache_page_table, or null before any block is looked up
+    BlockCache* block_cache;
+    const Memory::PageTable* block_cache_page_table;
+};
+
+} // namespace JitX64
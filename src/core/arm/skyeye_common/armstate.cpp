@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstring>
+
 #include "common/swap.h"
 #include "common/logging/log.h"
 #include "core/memory.h"
@@ -9,7 +11,7 @@
 #include "core/arm/skyeye_common/vfp/vfp.h"
 #include "core/gdbstub/gdbstub.h"
 
-ARMul_State::ARMul_State(PrivilegeMode initial_mode)
+ARMul_State::ARMul_State(PrivilegeMode initial_mode) : instruction_cache(nullptr), instruction_cache_page_table(nullptr)
 {
     Reset();
     ChangePrivilegeMode(initial_mode);
@@ -114,6 +116,7 @@ void ARMul_State::Reset()
 
     Cpsr = INTBITS | SVC32MODE;
     Mode = SVC32MODE;
+    lazy_flags = LazyFlags::None;
     Bank = SVCBANK;
 
     ResetMPCoreCP15Registers();
@@ -194,18 +197,33 @@ static void CheckMemoryBreakpoint(u32 address, GDBStub::BreakpointType type)
     }
 }
 
+// Loads from pages backed by host memory read the page table directly, like the code generated by
+// the recompiler, and only the other pages go through the Memory functions. Stores always go through
+// them, as they may have to invalidate translated code.
+template <typename T>
+static T ReadPageTable(u32 address, T (*read_slow)(VAddr))
+{
+    const u8* page_pointer = Memory::current_page_table->pointers[address >> Memory::PAGE_BITS];
+    if (page_pointer == nullptr)
+        return read_slow(address);
+
+    T value;
+    std::memcpy(&value, &page_pointer[address & Memory::PAGE_MASK], sizeof(T));
+    return value;
+}
+
 u8 ARMul_State::ReadMemory8(u32 address) const
 {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
-    return Memory::Read8(address);
+    return ReadPageTable<u8>(address, Memory::Read8);
 }
 
 u16 ARMul_State::ReadMemory16(u32 address) const
 {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
-    u16 data = Memory::Read16(address);
+    u16 data = ReadPageTable<u16>(address, Memory::Read16);
 
     if (InBigEndianMode())
         data = Common::swap16(data);
@@ -217,7 +235,7 @@ u32 ARMul_State::ReadMemory32(u32 address) const
 {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
-    u32 data = Memory::Read32(address);
+    u32 data = ReadPageTable<u32>(address, Memory::Read32);
 
     if (InBigEndianMode())
         data = Common::swap32(data);
@@ -229,7 +247,7 @@ u64 ARMul_State::ReadMemory64(u32 address) const
 {
     CheckMemoryBreakpoint(address, GDBStub::BreakpointType::Read);
 
-    u64 data = Memory::Read64(address);
+    u64 data = ReadPageTable<u64>(address, Memory::Read64);
 
     if (InBigEndianMode())
         data = Common::swap64(data);
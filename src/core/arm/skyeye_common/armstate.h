@@ -18,9 +18,14 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "common/common_types.h"
+#include "core/arm/block_table.h"
+#include "core/arm/dyncom/arm_dyncom_profiler.h"
 #include "core/arm/skyeye_common/arm_regformat.h"
 
 // Signal levels
@@ -134,6 +139,15 @@ enum : u32 {
     INTBITS = 0x1C0,
 };
 
+// How the NZCV flags are currently held, see the lazy flag functions in the dyncom interpreter.
+// Rather than computing the flags of every flag-setting instruction, the interpreter records the
+// inputs of the last one and only computes the flags when something reads them.
+enum class LazyFlags : u32 {
+    None, // NFlag, ZFlag, CFlag and VFlag are up to date
+    NZ,   // N and Z are derived from lazy_result, CFlag and VFlag are up to date
+    NZCV, // All flags are derived from the addition lazy_operand1 + lazy_operand2 + lazy_carry_in
+};
+
 // Values for Emulate.
 enum {
     STOP       = 0, // Stop
@@ -142,6 +156,23 @@ enum {
     RUN        = 3  // Continuous execution
 };
 
+// Translated dyncom blocks of one address space
+struct InstructionCache {
+    InstructionCache() : blocks(-1), generation(0) {}
+
+    // Maps guest addresses to the offset of their translated block in the instruction buffer, or -1
+    // if the address has not been translated yet.
+    BlockTable<int> blocks;
+    // Generation of the instruction buffer the blocks were translated in
+    u32 generation;
+
+    // Offsets in the instruction buffer of the dyncom block links that point into each guest page,
+    // so that they can be torn down when the page is invalidated.
+    std::unordered_map<u32, std::vector<int>> block_links;
+
+    // Guest pages that dyncom superblocks starting in the previous page extend into
+    std::unordered_set<u32> superblock_tail_pages;
+};
 
 struct ARMul_State final
 {
@@ -220,6 +251,11 @@ public:
     u32 Bank;          // The current register bank
 
     u32 NFlag, ZFlag, CFlag, VFlag, IFFlags; // Dummy flags for speed
+    LazyFlags lazy_flags;
+    u32 lazy_result;
+    u32 lazy_operand1;
+    u32 lazy_operand2;
+    u32 lazy_carry_in;
     unsigned int shifter_carry_out;
 
     u32 TFlag; // Thumb state
@@ -236,9 +272,15 @@ public:
     unsigned bigendSig;
     unsigned syscallSig;
 
-    // TODO(bunnei): Move this cache to a better place - it should be per codeset (likely per
-    // process for our purposes), not per ARMul_State (which tracks CPU core state).
-    std::unordered_map<u32, int> instruction_cache;
+    // Translated blocks of every address space the core has run code from, keyed by its page table.
+    // Switching address spaces only changes which one is used.
+    std::unordered_map<const Memory::PageTable*, std::unique_ptr<InstructionCache>> instruction_caches;
+    // Cache of the address space of instruction_cache_page_table, or null before any code runs
+    InstructionCache* instruction_cache;
+    const Memory::PageTable* instruction_cache_page_table;
+
+    // Counts block executions when hot block profiling is enabled, null otherwise
+    std::unique_ptr<BlockProfiler> block_profiler;
 
 private:
     void ResetMPCoreCP15Registers();
@@ -0,0 +1,206 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+#include "common/common_types.h"
+#include "core/arm/skyeye_common/vfp/asm_vfp.h"
+
+// Fast path running VFP data-processing instructions on the host FPU instead of the softfloat code
+// in vfpsingle.cpp and vfpdouble.cpp.
+//
+// It only handles the cases where IEEE 754 arithmetic on the host gives the same result and the same
+// cumulative exception flags as the softfloat code: round-to-nearest with no exception traps enabled,
+// normal or zero operands, and a normal or zero result. Those cases can raise nothing but the
+// inexact exception, which is detected by computing the rounding error exactly. Everything else is
+// declined so that the caller falls back to softfloat.
+
+namespace VFPHost {
+
+/// Indices of the data-processing ops, as returned by FOP_TO_IDX
+enum : u32 {
+    OP_FMAC  = 0,
+    OP_FMSC  = 1,
+    OP_FMUL  = 2,
+    OP_FADD  = 3,
+    OP_FNMAC = 4,
+    OP_FNMSC = 5,
+    OP_FNMUL = 6,
+    OP_FSUB  = 7,
+    OP_FDIV  = 8,
+};
+
+/// Checks whether the FPSCR configuration allows using the host FPU at all
+inline bool IsUsable(u32 fpscr) {
+    const u32 trap_enables = FPSCR_IDE | FPSCR_IXE | FPSCR_UFE | FPSCR_OFE | FPSCR_DZE | FPSCR_IOE;
+    return (fpscr & (FPSCR_RMODE_MASK | trap_enables)) == FPSCR_ROUND_NEAREST;
+}
+
+template <typename T>
+struct FloatTraits;
+
+template <>
+struct FloatTraits<float> {
+    using Bits = u32;
+    static const int EXPONENT_SHIFT = 23;
+    static const Bits EXPONENT_MASK = 0xFF;
+    static const Bits SIGNIFICAND_MASK = 0x7FFFFF;
+    /// Smallest biased exponent of a result whose rounding error is still exactly representable
+    static const Bits MIN_EXACT_ERROR_EXPONENT = 0;
+
+    /// Product computed exactly in a wider format
+    static bool IsProductExact(float a, float b, float product) {
+        return static_cast<double>(a) * b == product;
+    }
+
+    /// Whether quotient * b reproduces a exactly, computed in a wider format
+    static bool IsQuotientExact(float a, float b, float quotient) {
+        return static_cast<double>(quotient) * b == a;
+    }
+};
+
+template <>
+struct FloatTraits<double> {
+    using Bits = u64;
+    static const int EXPONENT_SHIFT = 52;
+    static const Bits EXPONENT_MASK = 0x7FF;
+    static const Bits SIGNIFICAND_MASK = 0xFFFFFFFFFFFFFull;
+    static const Bits MIN_EXACT_ERROR_EXPONENT = 0x80;
+
+    static bool IsProductExact(double a, double b, double product) {
+        return std::fma(a, b, -product) == 0.0;
+    }
+
+    static bool IsQuotientExact(double a, double b, double quotient) {
+        return std::fma(quotient, b, -a) == 0.0;
+    }
+};
+
+template <typename T>
+inline T FromBits(typename FloatTraits<T>::Bits bits) {
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+template <typename T>
+inline typename FloatTraits<T>::Bits ToBits(T value) {
+    typename FloatTraits<T>::Bits bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    return bits;
+}
+
+template <typename T>
+inline typename FloatTraits<T>::Bits BiasedExponent(T value) {
+    using Traits = FloatTraits<T>;
+    return (ToBits(value) >> Traits::EXPONENT_SHIFT) & Traits::EXPONENT_MASK;
+}
+
+/// Checks that a value is zero or a normal number, ie. neither denormal, infinite nor NaN
+template <typename T>
+inline bool IsNormalOrZero(T value) {
+    using Traits = FloatTraits<T>;
+    const typename Traits::Bits exponent = BiasedExponent(value);
+    if (exponent == Traits::EXPONENT_MASK)
+        return false;
+    return exponent != 0 || (ToBits(value) & Traits::SIGNIFICAND_MASK) == 0;
+}
+
+/**
+ * Checks that a result can be used as is, with its rounding error exactly representable so that
+ * the inexact flag can be computed from it.
+ */
+template <typename T>
+inline bool IsUsableResult(T result) {
+    return IsNormalOrZero(result) &&
+           (result == 0 || BiasedExponent(result) >= FloatTraits<T>::MIN_EXACT_ERROR_EXPONENT);
+}
+
+template <typename T>
+inline bool Add(T a, T b, T* result, u32* exceptions) {
+    const T sum = a + b;
+    if (!IsUsableResult(sum))
+        return false;
+
+    // Knuth's TwoSum, which gives the exact rounding error of the addition
+    const T b_virtual = sum - a;
+    const T error = (a - (sum - b_virtual)) + (b - b_virtual);
+
+    *result = sum;
+    *exceptions = error != 0 ? static_cast<u32>(FPSCR_IXC) : 0u;
+    return true;
+}
+
+template <typename T>
+inline bool Multiply(T a, T b, T* result, u32* exceptions) {
+    const T product = a * b;
+    if (!IsUsableResult(product))
+        return false;
+    // A zero product of non-zero operands has underflowed
+    if (product == 0 && a != 0 && b != 0)
+        return false;
+
+    *result = product;
+    *exceptions = FloatTraits<T>::IsProductExact(a, b, product) ? 0u : static_cast<u32>(FPSCR_IXC);
+    return true;
+}
+
+template <typename T>
+inline bool Divide(T a, T b, T* result, u32* exceptions) {
+    if (b == 0)
+        return false;
+
+    const T quotient = a / b;
+    if (!IsUsableResult(quotient))
+        return false;
+    if (quotient == 0 && a != 0)
+        return false;
+    if (a != 0 && BiasedExponent(a) < FloatTraits<T>::MIN_EXACT_ERROR_EXPONENT)
+        return false;
+
+    *result = quotient;
+    *exceptions = FloatTraits<T>::IsQuotientExact(a, b, quotient) ? 0u : static_cast<u32>(FPSCR_IXC);
+    return true;
+}
+
+/**
+ * Runs a VFP data-processing op on the host FPU.
+ * @param op Index of the op, see FOP_TO_IDX
+ * @param n First operand
+ * @param m Second operand
+ * @param fpscr Current FPSCR value
+ * @param result Receives the result
+ * @param exceptions Receives the cumulative exception flags raised by the op
+ * @return false if the op has to be run by the softfloat code instead
+ */
+template <typename T>
+inline bool ExecuteOp(u32 op, T n, T m, u32 fpscr, T* result, u32* exceptions) {
+    if (!IsUsable(fpscr) || !IsNormalOrZero(n) || !IsNormalOrZero(m))
+        return false;
+
+    switch (op) {
+    case OP_FADD:
+        return Add(n, m, result, exceptions);
+    case OP_FSUB:
+        return Add(n, -m, result, exceptions);
+    case OP_FMUL:
+        return Multiply(n, m, result, exceptions);
+    case OP_FNMUL:
+        if (!Multiply(n, m, result, exceptions))
+            return false;
+        *result = -*result;
+        return true;
+    case OP_FDIV:
+        return Divide(n, m, result, exceptions);
+    default:
+        // The multiply-accumulate ops are left to the softfloat code, which adds the unrounded
+        // product and so rounds differently from the host whenever the product is inexact.
+        return false;
+    }
+}
+
+} // namespace VFPHost
@@ -56,6 +56,7 @@
 #include "core/arm/skyeye_common/vfp/vfp.h"
 #include "core/arm/skyeye_common/vfp/vfp_helper.h"
 #include "core/arm/skyeye_common/vfp/asm_vfp.h"
+#include "core/arm/skyeye_common/vfp/vfp_host.h"
 
 static struct vfp_double vfp_double_default_qnan = {
     2047,
@@ -1160,6 +1161,22 @@ invalid:
     return FPSCR_IOC;
 }
 
+/*
+ * Runs a data-processing op on the host FPU if it gives the same result
+ * as the softfloat code, see vfp_host.h. Returns false if the op has to
+ * be run by the softfloat code instead.
+ */
+static bool vfp_double_host_op(ARMul_State* state, u32 op, int dd, int dn, int dm, u32 fpscr, u32* exceptions)
+{
+    double result;
+    if (!VFPHost::ExecuteOp(op, VFPHost::FromBits<double>(vfp_get_double(state, dn)),
+                            VFPHost::FromBits<double>(vfp_get_double(state, dm)), fpscr, &result, exceptions))
+        return false;
+
+    vfp_put_double(state, VFPHost::ToBits(result), dd);
+    return true;
+}
+
 static struct op fops[] = {
     { vfp_double_fmac,  0 },
     { vfp_double_fmsc,  0 },
@@ -1238,7 +1255,8 @@ u32 vfp_double_cpdo(ARMul_State* state, u32 inst, u32 fpscr)
                      vecitr >> FPSCR_LENGTH_BIT,
                      type, dest, dn, FOP_TO_IDX(op), dm);
 
-        except = fop->fn(state, dest, dn, dm, fpscr);
+        if (op == FOP_EXT || !vfp_double_host_op(state, FOP_TO_IDX(op), dest, dn, dm, fpscr, &except))
+            except = fop->fn(state, dest, dn, dm, fpscr);
         LOG_TRACE(Core_ARM11, "VFP: itr%d: exceptions=%08x",
                  vecitr >> FPSCR_LENGTH_BIT, except);
 
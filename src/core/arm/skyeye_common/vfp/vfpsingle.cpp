@@ -61,6 +61,7 @@
 #include "core/arm/skyeye_common/vfp/vfp_helper.h"
 #include "core/arm/skyeye_common/vfp/asm_vfp.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
+#include "core/arm/skyeye_common/vfp/vfp_host.h"
 
 static struct vfp_single vfp_single_default_qnan = {
     255,
@@ -1191,6 +1192,22 @@ invalid:
     return FPSCR_IOC;
 }
 
+/*
+ * Runs a data-processing op on the host FPU if it gives the same result
+ * as the softfloat code, see vfp_host.h. Returns false if the op has to
+ * be run by the softfloat code instead.
+ */
+static bool vfp_single_host_op(ARMul_State* state, u32 op, int sd, int sn, s32 m, u32 fpscr, u32* exceptions)
+{
+    float result;
+    if (!VFPHost::ExecuteOp(op, VFPHost::FromBits<float>(vfp_get_float(state, sn)),
+                            VFPHost::FromBits<float>(m), fpscr, &result, exceptions))
+        return false;
+
+    vfp_put_float(state, VFPHost::ToBits(result), sd);
+    return true;
+}
+
 static struct op fops[] = {
 	{ vfp_single_fmac,  0 },
 	{ vfp_single_fmsc,  0 },
@@ -1264,7 +1281,8 @@ u32 vfp_single_cpdo(ARMul_State* state, u32 inst, u32 fpscr)
                       vecitr >> FPSCR_LENGTH_BIT, type, dest, sn,
                       FOP_TO_IDX(op), sm, m);
 
-        except = fop->fn(state, dest, sn, m, fpscr);
+        if (op == FOP_EXT || !vfp_single_host_op(state, FOP_TO_IDX(op), dest, sn, m, fpscr, &except))
+            except = fop->fn(state, dest, sn, m, fpscr);
         LOG_TRACE(Core_ARM11, "itr%d: exceptions=%08x",
                   vecitr >> FPSCR_LENGTH_BIT, except);
 
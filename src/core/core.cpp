@@ -9,9 +9,13 @@
 
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/settings.h"
 
 #include "core/arm/arm_interface.h"
 #include "core/arm/dyncom/arm_dyncom.h"
+#ifdef ARCHITECTURE_x86_64
+#include "core/arm/jit_x64/arm_jit_x64.h"
+#endif
 #include "core/hle/hle.h"
 #include "core/hle/kernel/thread.h"
 #include "core/hw/hw.h"
@@ -72,10 +76,19 @@ void Stop() {
     // TODO(ShizZy): ImplementMe
 }
 
+/// Creates the CPU core implementation selected in the settings
+static std::unique_ptr<ARM_Interface> CreateCore(PrivilegeMode initial_mode) {
+#ifdef ARCHITECTURE_x86_64
+    if (Settings::values.use_cpu_jit)
+        return Common::make_unique<ARM_JitX64>(initial_mode);
+#endif
+    return Common::make_unique<ARM_DynCom>(initial_mode);
+}
+
 /// Initialize the core
 int Init() {
-    g_sys_core = Common::make_unique<ARM_DynCom>(USER32MODE);
-    g_app_core = Common::make_unique<ARM_DynCom>(USER32MODE);
+    g_sys_core = CreateCore(USER32MODE);
+    g_app_core = CreateCore(USER32MODE);
 
     LOG_DEBUG(Core, "Initialized OK");
     return 0;
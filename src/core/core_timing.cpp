@@ -2,14 +2,16 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
 #include <cinttypes>
-#include <mutex>
+#include <thread>
 #include <vector>
 
-#include "common/chunk_file.h"
+#include "common/assert.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/thread.h"
 
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
@@ -43,18 +45,71 @@ struct BaseEvent
     int type;
 };
 
-typedef LinkedListItem<BaseEvent> Event;
+struct Event : BaseEvent
+{
+    /// Order in which the event was queued, which breaks ties between events due at the same time
+    u64 order;
+    /// Set when the event is unscheduled, it is then dropped once it reaches the top of the heap
+    bool cancelled;
+    /// Whether the event was scheduled from another thread, it then goes back to ts_free once freed
+    bool threadsafe;
+    /// Next event in the same bucket of event_buckets, or in event_list while the queue is short.
+    /// Events scheduled from other threads are linked through it until they are queued.
+    Event* bucket_next;
+    /// Pointer to this event in its bucket chain, which allows unlinking it without hashing
+    Event** bucket_link;
+};
 
-static Event* first;
+struct QueueEntry
+{
+    s64 time;
+    u64 order;
+    Event* event;
+};
+
+// Pending events. While only a few are pending, which is the usual case, they are kept in a list
+// sorted by time and chained through the events themselves. Firing an event then only unlinks the
+// head of the list, and scheduling one walks the few events due before it. Once more than
+// EVENT_LIST_MAX events are pending, they move to a binary min-heap ordered by time and then by
+// queueing order, and they move back to the list once the heap shrinks to a quarter of that.
+// Either way, events due at the same time fire in the order they were scheduled. The sort key is
+// kept in the heap entries so that sifting does not touch the events themselves.
+// Unscheduled events of the heap are only flagged as cancelled and stay in it until they reach its
+// top, or until they make up most of it and the heap is rebuilt without them.
+static Event* event_list;
+static size_t num_listed_events;
+static const size_t EVENT_LIST_MAX = 32;
+static bool events_in_heap;
+static std::vector<QueueEntry> event_queue;
+static size_t num_cancelled_events;
+// Hash table of the events of the heap by type and userdata, chained through the events themselves,
+// to find the events to unschedule without scanning the heap
+static std::vector<Event*> event_buckets;
+static unsigned event_bucket_bits;
+static size_t num_linked_events;
+static const unsigned INITIAL_EVENT_BUCKET_BITS = 6;
+static u64 event_order;
+
+// Events scheduled from other threads, newest first. This is a lock-free stack which the CPU
+// thread only ever empties as a whole, so pushing needs no lock and is not subject to ABA.
+static std::atomic<Event*> ts_incoming(nullptr);
+// Events taken from ts_incoming but not queued yet, oldest first. Only used by the CPU thread.
 static Event* ts_first;
 static Event* ts_last;
 
-// event pools
-static Event* event_pool = nullptr;
-static Event* event_ts_pool = nullptr;
-static int allocated_ts_events = 0;
-// Optimization to skip MoveEvents when possible.
-static std::atomic<bool> has_ts_events(false);
+// event pool, of the CPU thread, chained through bucket_next
+static Event* event_pool;
+// Free events for ScheduleEvent_Threadsafe. The CPU thread pushes the events scheduled from other
+// threads back onto this stack once they are freed, and the other threads take it as a whole into
+// ts_free_cache, so that it is lock-free and not subject to ABA either.
+static std::atomic<Event*> ts_free(nullptr);
+// Free events of the calling thread for ScheduleEvent_Threadsafe, taken from ts_free
+static thread_local Event* ts_free_cache;
+
+#ifdef _DEBUG
+// Thread running Advance, which is the only one allowed to access the event queue
+static std::thread::id cpu_thread_id;
+#endif
 
 int g_slice_length;
 
@@ -63,8 +118,6 @@ static s64 idled_cycles;
 static s64 last_global_time_ticks;
 static s64 last_global_time_us;
 
-static std::recursive_mutex external_event_section;
-
 // Warning: not included in save state.
 using AdvanceCallback = void(int cycles_executed);
 static AdvanceCallback* advance_callback = nullptr;
@@ -99,34 +152,234 @@ u64 GetGlobalTimeUs() {
 }
 
 static Event* GetNewEvent() {
-    if (!event_pool)
-        return new Event;
+    if (!event_pool) {
+        Event* event = new Event;
+        event->threadsafe = false;
+        return event;
+    }
 
     Event* event = event_pool;
-    event_pool = event->next;
+    event_pool = event->bucket_next;
     return event;
 }
 
-static Event* GetNewTsEvent() {
-    allocated_ts_events++;
+static void FreeEvent(Event* event) {
+    if (event->threadsafe) {
+        Event* head = ts_free.load(std::memory_order_relaxed);
+        do {
+            event->bucket_next = head;
+        } while (!ts_free.compare_exchange_weak(head, event, std::memory_order_release,
+                                                std::memory_order_relaxed));
+        return;
+    }
 
-    if (!event_ts_pool)
-        return new Event;
+    event->bucket_next = event_pool;
+    event_pool = event;
+}
 
-    Event* event = event_ts_pool;
-    event_ts_pool = event->next;
-    return event;
+static size_t GetBucketIndex(int type, u64 userdata) {
+    // Fibonacci hashing, which takes the bucket index from the well mixed upper bits
+    const u64 hash = (userdata ^ (static_cast<u64>(type) << 40)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(hash >> (64 - event_bucket_bits));
 }
 
-static void FreeEvent(Event* event) {
-    event->next = event_pool;
-    event_pool = event;
+static void InsertIntoBucket(Event* event) {
+    Event*& head = event_buckets[GetBucketIndex(event->type, event->userdata)];
+    event->bucket_next = head;
+    if (head)
+        head->bucket_link = &event->bucket_next;
+    head = event;
+    event->bucket_link = &head;
+}
+
+static void ResetEventBuckets() {
+    event_bucket_bits = INITIAL_EVENT_BUCKET_BITS;
+    event_buckets.assign(size_t(1) << event_bucket_bits, nullptr);
+    num_linked_events = 0;
+}
+
+static void LinkEvent(Event* event) {
+    if (num_linked_events >= event_buckets.size()) {
+        std::vector<Event*> old_buckets(size_t(1) << ++event_bucket_bits, nullptr);
+        old_buckets.swap(event_buckets);
+        for (Event* bucket : old_buckets) {
+            while (bucket) {
+                Event* next = bucket->bucket_next;
+                InsertIntoBucket(bucket);
+                bucket = next;
+            }
+        }
+    }
+
+    InsertIntoBucket(event);
+    num_linked_events++;
+}
+
+/// Removes an event from the hash table, once it has fired or been unscheduled
+static void UnlinkEvent(Event* event) {
+    *event->bucket_link = event->bucket_next;
+    if (event->bucket_next)
+        event->bucket_next->bucket_link = event->bucket_link;
+    num_linked_events--;
+}
+
+/// Heap comparator, which puts the earliest event at the top
+static bool EntryAfter(const QueueEntry& a, const QueueEntry& b) {
+    return a.time > b.time || (a.time == b.time && a.order > b.order);
+}
+
+/// Moves the events of the list to the heap, once there are too many of them
+static void MoveListToHeap() {
+    // The list is in firing order, which already makes a valid heap
+    Event* event = event_list;
+    while (event) {
+        Event* next = event->bucket_next;
+        event_queue.push_back(QueueEntry{event->time, event->order, event});
+        LinkEvent(event);
+        event = next;
+    }
+    event_list = nullptr;
+    num_listed_events = 0;
+    events_in_heap = true;
+}
+
+/// Moves the events of the heap back to the list if the heap has become short enough
+static void MoveShortHeapToList() {
+    if (event_queue.size() > EVENT_LIST_MAX / 4)
+        return;
+
+    // Only the events of the heap are in the hash table, so it can be emptied as a whole
+    ResetEventBuckets();
+
+    // Pushing the events latest first onto the list leaves it in firing order
+    std::sort(event_queue.begin(), event_queue.end(), EntryAfter);
+    for (const QueueEntry& entry : event_queue) {
+        Event* event = entry.event;
+        if (event->cancelled) {
+            FreeEvent(event);
+            continue;
+        }
+        event->bucket_next = event_list;
+        event_list = event;
+        num_listed_events++;
+    }
+    event_queue.clear();
+    num_cancelled_events = 0;
+    events_in_heap = false;
+}
+
+static void AddEventToQueue(Event* new_event) {
+    new_event->order = event_order++;
+    new_event->cancelled = false;
+
+    if (!events_in_heap) {
+        if (num_listed_events < EVENT_LIST_MAX) {
+            Event** link = &event_list;
+            while (*link && (*link)->time <= new_event->time)
+                link = &(*link)->bucket_next;
+            new_event->bucket_next = *link;
+            *link = new_event;
+            num_listed_events++;
+            return;
+        }
+        MoveListToHeap();
+    }
+
+    event_queue.push_back(QueueEntry{new_event->time, new_event->order, new_event});
+    std::push_heap(event_queue.begin(), event_queue.end(), EntryAfter);
+    LinkEvent(new_event);
+}
+
+static void PopHeapTop() {
+    std::pop_heap(event_queue.begin(), event_queue.end(), EntryAfter);
+    event_queue.pop_back();
+    MoveShortHeapToList();
 }
 
-static void FreeTsEvent(Event* event) {
-    event->next = event_ts_pool;
-    event_ts_pool = event;
-    allocated_ts_events--;
+/// Returns the next event to fire, or nullptr if there is none
+static Event* GetFirstEvent() {
+    // The heap is never left short, so it can't run out of events while cancelled ones are dropped
+    while (events_in_heap) {
+        Event* event = event_queue.front().event;
+        if (!event->cancelled)
+            return event;
+
+        num_cancelled_events--;
+        PopHeapTop();
+        FreeEvent(event);
+    }
+    return event_list;
+}
+
+/// Removes the event returned by GetFirstEvent from the queue, once it fires
+static void PopFirstEvent(Event* event) {
+    if (!events_in_heap) {
+        event_list = event->bucket_next;
+        num_listed_events--;
+        return;
+    }
+
+    UnlinkEvent(event);
+    PopHeapTop();
+}
+
+static void CancelEvent(Event* event) {
+    UnlinkEvent(event);
+    event->cancelled = true;
+    num_cancelled_events++;
+}
+
+/// Rebuilds the heap without the cancelled events once they make up most of it
+static void PruneCancelledEvents() {
+    if (num_cancelled_events < 64 || num_cancelled_events < event_queue.size() / 2)
+        return;
+
+    auto end = std::remove_if(event_queue.begin(), event_queue.end(), [](const QueueEntry& entry) {
+        if (!entry.event->cancelled)
+            return false;
+        FreeEvent(entry.event);
+        return true;
+    });
+    event_queue.erase(end, event_queue.end());
+    num_cancelled_events = 0;
+    std::make_heap(event_queue.begin(), event_queue.end(), EntryAfter);
+    MoveShortHeapToList();
+}
+
+/// Unschedules the events matching the predicate. Listed events are passed to it in firing order.
+template <typename Predicate>
+static void CancelEventsIf(Predicate pred) {
+    if (!events_in_heap) {
+        Event** link = &event_list;
+        while (Event* event = *link) {
+            if (pred(event)) {
+                *link = event->bucket_next;
+                num_listed_events--;
+                FreeEvent(event);
+            } else {
+                link = &event->bucket_next;
+            }
+        }
+        return;
+    }
+
+    for (const QueueEntry& entry : event_queue) {
+        Event* event = entry.event;
+        if (!event->cancelled && pred(event))
+            CancelEvent(event);
+    }
+    PruneCancelledEvents();
+}
+
+/// Calls the function on every pending event, in no particular order
+template <typename Func>
+static void ForEachPendingEvent(Func func) {
+    for (Event* event = event_list; event; event = event->bucket_next)
+        func(event);
+    for (const QueueEntry& entry : event_queue) {
+        if (!entry.event->cancelled)
+            func(entry.event);
+    }
 }
 
 int RegisterEvent(const char* name, TimedCallback callback) {
@@ -147,7 +400,7 @@ void RestoreRegisterEvent(int event_type, const char* name, TimedCallback callba
 }
 
 void UnregisterAllEvents() {
-    if (first)
+    if (GetFirstEvent() != nullptr)
         LOG_ERROR(Core_Timing, "Cannot unregister events with events pending");
     event_types.clear();
 }
@@ -159,16 +412,24 @@ void Init() {
     idled_cycles = 0;
     last_global_time_ticks = 0;
     last_global_time_us = 0;
-    has_ts_events = 0;
     mhz_change_callbacks.clear();
 
-    first = nullptr;
+    event_list = nullptr;
+    num_listed_events = 0;
+    events_in_heap = false;
+    event_queue.clear();
+    num_cancelled_events = 0;
+    ResetEventBuckets();
+    event_order = 0;
+    ts_incoming = nullptr;
     ts_first = nullptr;
     ts_last = nullptr;
 
     event_pool = nullptr;
-    event_ts_pool = nullptr;
-    allocated_ts_events = 0;
+    ts_free = nullptr;
+#ifdef _DEBUG
+    cpu_thread_id = std::thread::id();
+#endif
 
     advance_callback = nullptr;
 }
@@ -179,16 +440,15 @@ void Shutdown() {
     UnregisterAllEvents();
 
     while (event_pool) {
-        Event* event = event_pool;
-        event_pool = event->next;
-        delete event;
+        Event* next = event_pool->bucket_next;
+        delete event_pool;
+        event_pool = next;
     }
-
-    std::lock_guard<std::recursive_mutex> lock(external_event_section);
-    while (event_ts_pool) {
-        Event* event = event_ts_pool;
-        event_ts_pool = event->next;
+    Event* event = ts_free.exchange(nullptr);
+    while (event) {
+        Event* next = event->bucket_next;
         delete event;
+        event = next;
     }
 }
 
@@ -204,19 +464,26 @@ u64 GetIdleTicks() {
 // This is to be called when outside threads, such as the graphics thread, wants to
 // schedule things to be executed on the main thread.
 void ScheduleEvent_Threadsafe(s64 cycles_into_future, int event_type, u64 userdata) {
-    std::lock_guard<std::recursive_mutex> lock(external_event_section);
-    Event* new_event = GetNewTsEvent();
+    // The event pool belongs to the CPU thread, so this takes the event from the free events of
+    // the calling thread, which are refilled with the events the CPU thread has freed since.
+    if (!ts_free_cache)
+        ts_free_cache = ts_free.exchange(nullptr, std::memory_order_acquire);
+    Event* new_event = ts_free_cache;
+    if (new_event) {
+        ts_free_cache = new_event->bucket_next;
+    } else {
+        new_event = new Event;
+        new_event->threadsafe = true;
+    }
     new_event->time = GetTicks() + cycles_into_future;
     new_event->type = event_type;
-    new_event->next = nullptr;
     new_event->userdata = userdata;
-    if (!ts_first)
-        ts_first = new_event;
-    if (ts_last)
-        ts_last->next = new_event;
-    ts_last = new_event;
 
-    has_ts_events = true;
+    Event* head = ts_incoming.load(std::memory_order_relaxed);
+    do {
+        new_event->bucket_next = head;
+    } while (!ts_incoming.compare_exchange_weak(head, new_event, std::memory_order_release,
+                                                std::memory_order_relaxed));
 }
 
 // Same as ScheduleEvent_Threadsafe(0, ...) EXCEPT if we are already on the CPU thread
@@ -224,7 +491,6 @@ void ScheduleEvent_Threadsafe(s64 cycles_into_future, int event_type, u64 userda
 void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata) {
     if (false) //Core::IsCPUThread())
     {
-        std::lock_guard<std::recursive_mutex> lock(external_event_section);
         event_types[event_type].callback(userdata, 0);
     }
     else
@@ -232,26 +498,19 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata) {
 }
 
 void ClearPendingEvents() {
-    while (first) {
-        Event* event = first->next;
-        FreeEvent(first);
-        first = event;
+    while (event_list) {
+        Event* next = event_list->bucket_next;
+        FreeEvent(event_list);
+        event_list = next;
     }
-}
+    num_listed_events = 0;
+    events_in_heap = false;
 
-static void AddEventToQueue(Event* new_event) {
-    Event* prev_event = nullptr;
-    Event** next_event = &first;
-    for (;;) {
-        Event*& next = *next_event;
-        if (!next || new_event->time < next->time) {
-            new_event->next = next;
-            next = new_event;
-            break;
-        }
-        prev_event = next;
-        next_event = &prev_event->next;
-    }
+    for (const QueueEntry& entry : event_queue)
+        FreeEvent(entry.event);
+    event_queue.clear();
+    num_cancelled_events = 0;
+    ResetEventBuckets();
 }
 
 void ScheduleEvent(s64 cycles_into_future, int event_type, u64 userdata) {
@@ -264,82 +523,90 @@ void ScheduleEvent(s64 cycles_into_future, int event_type, u64 userdata) {
 
 s64 UnscheduleEvent(int event_type, u64 userdata) {
     s64 result = 0;
-    if (!first)
+    // If several events match, the result is the one of the last event in firing order
+    if (!events_in_heap) {
+        CancelEventsIf([&](const Event* event) {
+            if (event->type != event_type || event->userdata != userdata)
+                return false;
+            result = event->time - GetTicks();
+            return true;
+        });
         return result;
-    while (first) {
-        if (first->type == event_type && first->userdata == userdata) {
-            result = first->time - GetTicks();
-
-            Event* next = first->next;
-            FreeEvent(first);
-            first = next;
-        } else {
-            break;
-        }
     }
-    if (!first)
-        return result;
-
-    Event* prev_event = first;
-    Event* ptr = prev_event->next;
 
-    while (ptr) {
-        if (ptr->type == event_type && ptr->userdata == userdata) {
-            result = ptr->time - GetTicks();
-
-            prev_event->next = ptr->next;
-            FreeEvent(ptr);
-            ptr = prev_event->next;
-        } else {
-            prev_event = ptr;
-            ptr = ptr->next;
+    const Event* last_event = nullptr;
+    Event* event = event_buckets[GetBucketIndex(event_type, userdata)];
+    while (event) {
+        Event* next = event->bucket_next;
+        if (event->type == event_type && event->userdata == userdata) {
+            if (last_event == nullptr || event->time > last_event->time ||
+                (event->time == last_event->time && event->order > last_event->order)) {
+                result = event->time - GetTicks();
+                last_event = event;
+            }
+            CancelEvent(event);
         }
+        event = next;
     }
+    PruneCancelledEvents();
 
     return result;
 }
 
-s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata) {
-    s64 result = 0;
-    std::lock_guard<std::recursive_mutex> lock(external_event_section);
-    if (!ts_first)
-        return result;
-
-    while (ts_first) {
-        if (ts_first->type == event_type && ts_first->userdata == userdata) {
-            result = ts_first->time - GetTicks();
-
-            Event* next = ts_first->next;
-            FreeTsEvent(ts_first);
-            ts_first = next;
-        } else {
-            break;
-        }
-    }
+/// Appends the events scheduled by other threads since the last call to the ts_first list
+static void TakeThreadsafeEvents() {
+    Event* event = ts_incoming.exchange(nullptr, std::memory_order_acquire);
+    if (!event)
+        return;
 
-    if (!ts_first)
-    {
-        ts_last = nullptr;
-        return result;
+    // Reverse the stack to get the events in scheduling order
+    Event* taken_last = event;
+    Event* taken_first = nullptr;
+    while (event) {
+        Event* next = event->bucket_next;
+        event->bucket_next = taken_first;
+        taken_first = event;
+        event = next;
     }
 
-    Event* prev_event = ts_first;
-    Event* next = prev_event->next;
-    while (next) {
-        if (next->type == event_type && next->userdata == userdata) {
-            result = next->time - GetTicks();
-
-            prev_event->next = next->next;
-            if (next == ts_last)
-                ts_last = prev_event;
-            FreeTsEvent(next);
-            next = prev_event->next;
+    if (ts_last)
+        ts_last->bucket_next = taken_first;
+    else
+        ts_first = taken_first;
+    ts_last = taken_last;
+}
+
+/// Frees the threadsafe events matching the predicate, which have not been queued yet
+template <typename Predicate>
+static void RemoveThreadsafeEventsIf(Predicate pred) {
+#ifdef _DEBUG
+    // Only the CPU thread may take the events, the other threads can only schedule them
+    DEBUG_ASSERT(cpu_thread_id == std::thread::id() || cpu_thread_id == std::this_thread::get_id());
+#endif
+    TakeThreadsafeEvents();
+
+    Event** link = &ts_first;
+    Event* prev = nullptr;
+    while (Event* event = *link) {
+        if (pred(event)) {
+            *link = event->bucket_next;
+            FreeEvent(event);
         } else {
-            prev_event = next;
-            next = next->next;
+            prev = event;
+            link = &event->bucket_next;
         }
     }
+    ts_last = prev;
+}
 
+s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata) {
+    s64 result = 0;
+    RemoveThreadsafeEventsIf([&](const Event* event) {
+        if (event->type != event_type || event->userdata != userdata)
+            return false;
+        result = event->time - GetTicks();
+        return true;
+    });
     return result;
 }
 
@@ -353,79 +620,20 @@ void RegisterMHzChangeCallback(MHzChangeCallback callback) {
 }
 
 bool IsScheduled(int event_type) {
-    if (!first)
-        return false;
-    Event* event = first;
-    while (event) {
+    bool scheduled = false;
+    ForEachPendingEvent([&](const Event* event) {
         if (event->type == event_type)
-            return true;
-        event = event->next;
-    }
-    return false;
+            scheduled = true;
+    });
+    return scheduled;
 }
 
 void RemoveEvent(int event_type) {
-    if (!first)
-        return;
-    while (first) {
-        if (first->type == event_type) {
-            Event *next = first->next;
-            FreeEvent(first);
-            first = next;
-        } else {
-            break;
-        }
-    }
-    if (!first)
-        return;
-    Event* prev = first;
-    Event* next = prev->next;
-    while (next) {
-        if (next->type == event_type) {
-            prev->next = next->next;
-            FreeEvent(next);
-            next = prev->next;
-        } else {
-            prev = next;
-            next = next->next;
-        }
-    }
+    CancelEventsIf([event_type](const Event* event) { return event->type == event_type; });
 }
 
 void RemoveThreadsafeEvent(int event_type) {
-    std::lock_guard<std::recursive_mutex> lock(external_event_section);
-    if (!ts_first)
-        return;
-
-    while (ts_first) {
-        if (ts_first->type == event_type) {
-            Event* next = ts_first->next;
-            FreeTsEvent(ts_first);
-            ts_first = next;
-        } else {
-            break;
-        }
-    }
-
-    if (!ts_first) {
-        ts_last = nullptr;
-        return;
-    }
-
-    Event* prev = ts_first;
-    Event* next = prev->next;
-    while (next) {
-        if (next->type == event_type) {
-            prev->next = next->next;
-            if (next == ts_last)
-                ts_last = prev;
-            FreeTsEvent(next);
-            next = prev->next;
-        } else {
-            prev = next;
-            next = next->next;
-        }
-    }
+    RemoveThreadsafeEventsIf([event_type](const Event* event) { return event->type == event_type; });
 }
 
 void RemoveAllEvents(int event_type) {
@@ -435,10 +643,9 @@ void RemoveAllEvents(int event_type) {
 
 // This raise only the events required while the fifo is processing data
 void ProcessFifoWaitEvents() {
-    while (first) {
-        if (first->time <= (s64)GetTicks()) {
-            Event* evt = first;
-            first = first->next;
+    while (Event* evt = GetFirstEvent()) {
+        if (evt->time <= (s64)GetTicks()) {
+            PopFirstEvent(evt);
             event_types[evt->type].callback(evt->userdata, (int)(GetTicks() - evt->time));
             FreeEvent(evt);
         } else {
@@ -448,25 +655,15 @@ void ProcessFifoWaitEvents() {
 }
 
 void MoveEvents() {
-    has_ts_events = false;
+    TakeThreadsafeEvents();
 
-    std::lock_guard<std::recursive_mutex> lock(external_event_section);
     // Move events from async queue into main queue
     while (ts_first) {
-        Event* next = ts_first->next;
+        Event* next = ts_first->bucket_next;
         AddEventToQueue(ts_first);
         ts_first = next;
     }
     ts_last = nullptr;
-
-    // Move free events to threadsafe pool
-    while (allocated_ts_events > 0 && event_pool) {
-        Event* event = event_pool;
-        event_pool = event->next;
-        event->next = event_ts_pool;
-        event_ts_pool = event;
-        allocated_ts_events--;
-    }
 }
 
 void ForceCheck() {
@@ -479,14 +676,18 @@ void ForceCheck() {
 }
 
 void Advance() {
+#ifdef _DEBUG
+    cpu_thread_id = std::this_thread::get_id();
+#endif
     s64 cycles_executed = g_slice_length - Core::g_app_core->down_count;
     global_timer += cycles_executed;
     Core::g_app_core->down_count = g_slice_length;
 
-    if (has_ts_events)
+    if (ts_first || ts_incoming.load(std::memory_order_relaxed))
         MoveEvents();
     ProcessFifoWaitEvents();
 
+    const Event* first = GetFirstEvent();
     if (!first) {
         if (g_slice_length < 10000) {
             g_slice_length += 10000;
@@ -507,11 +708,9 @@ void Advance() {
 }
 
 void LogPendingEvents() {
-    Event* event = first;
-    while (event) {
-        //LOG_TRACE(Core_Timing, "PENDING: Now: %lld Pending: %lld Type: %d", globalTimer, next->time, next->type);
-        event = event->next;
-    }
+    ForEachPendingEvent([](const Event* event) {
+        //LOG_TRACE(Core_Timing, "PENDING: Now: %lld Pending: %lld Type: %d", globalTimer, event->time, event->type);
+    });
 }
 
 void Idle(int max_idle) {
@@ -519,6 +718,7 @@ void Idle(int max_idle) {
     if (max_idle != 0 && cycles_down > max_idle)
         cycles_down = max_idle;
 
+    const Event* first = GetFirstEvent();
     if (first && cycles_down > 0) {
         s64 cycles_executed = g_slice_length - Core::g_app_core->down_count;
         s64 cycles_next_event = first->time - global_timer;
@@ -540,10 +740,17 @@ void Idle(int max_idle) {
 }
 
 std::string GetScheduledEventsSummary() {
-    Event* event = first;
+    std::vector<QueueEntry> entries;
+    ForEachPendingEvent([&entries](Event* event) {
+        entries.push_back(QueueEntry{event->time, event->order, event});
+    });
+    std::sort(entries.begin(), entries.end(),
+              [](const QueueEntry& a, const QueueEntry& b) { return EntryAfter(b, a); });
+
     std::string text = "Scheduled events\n";
     text.reserve(1000);
-    while (event) {
+    for (const QueueEntry& entry : entries) {
+        const Event* event = entry.event;
         unsigned int t = event->type;
         if (t >= event_types.size())
             LOG_ERROR(Core_Timing, "Invalid event type"); // %i", t);
@@ -552,7 +759,6 @@ std::string GetScheduledEventsSummary() {
             name = "[unknown]";
         text += Common::StringFromFormat("%s : %i %08x%08x\n", name, (int)event->time,
                 (u32)(event->userdata >> 32), (u32)(event->userdata));
-        event = event->next;
     }
     return text;
 }
@@ -96,6 +96,10 @@ void UnregisterAllEvents();
  */
 void ScheduleEvent(s64 cycles_into_future, int event_type, u64 userdata = 0);
 
+/**
+ * Schedules an event from any thread. The event is queued by the CPU thread on its next call to
+ * Advance. This never takes a lock.
+ */
 void ScheduleEvent_Threadsafe(s64 cycles_into_future, int event_type, u64 userdata = 0);
 void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata = 0);
 
@@ -107,9 +111,11 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata = 0);
  */
 s64 UnscheduleEvent(int event_type, u64 userdata);
 
+/// Unschedules threadsafe events which have not been queued yet. This must be run from the cpu thread.
 s64 UnscheduleThreadsafeEvent(int event_type, u64 userdata);
 
 void RemoveEvent(int event_type);
+/// Removes threadsafe events which have not been queued yet. This must be run from the cpu thread.
 void RemoveThreadsafeEvent(int event_type);
 void RemoveAllEvents(int event_type);
 bool IsScheduled(int event_type);
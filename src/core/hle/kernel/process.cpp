@@ -7,6 +7,8 @@
 #include "common/logging/log.h"
 #include "common/make_unique.h"
 
+#include "core/core.h"
+#include "core/arm/arm_interface.h"
 #include "core/hle/kernel/memory.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/resource_limit.h"
@@ -127,7 +129,14 @@ void Process::Run(s32 main_thread_priority, u32 stack_size) {
     memory_region->used += stack_size;
 
     vm_manager.LogLayout(Log::Level::Debug);
+
+    // Creating the main thread already accesses the memory of the process, so its address space has
+    // to be current before the thread is ever scheduled
+    Memory::SetCurrentPageTable(&vm_manager.page_table);
+
     Kernel::SetupMainThread(codeset->entrypoint, main_thread_priority);
+
+    Core::g_app_core->LoadTranslationCache(codeset->program_id);
 }
 
 VAddr Process::GetLinearHeapBase() const {
@@ -9,6 +9,7 @@
 #include "common/common_types.h"
 
 #include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/slab_allocator.h"
 #include "core/hle/result.h"
 
 namespace Kernel {
@@ -26,7 +27,7 @@ enum class MemoryPermission : u32 {
     DontCare         = (1u << 28)
 };
 
-class SharedMemory final : public Object {
+class SharedMemory final : public Object, public SlabAllocated<SharedMemory> {
 public:
     /**
      * Creates a shared memory object
@@ -0,0 +1,89 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <mutex>
+
+#include "common/assert.h"
+
+#include "core/hle/kernel/slab_allocator.h"
+
+namespace Kernel {
+
+// Allocators are registered from the emulation thread and listed from the debugger
+static std::mutex allocators_mutex;
+static std::vector<const SlabAllocator*> allocators;
+
+SlabAllocator::SlabAllocator(HandleType type, size_t object_size)
+    : type(type), object_size(std::max(object_size, sizeof(FreeObject))) {
+    std::lock_guard<std::mutex> lock(allocators_mutex);
+    allocators.push_back(this);
+}
+
+void* SlabAllocator::Allocate(size_t size) {
+    ASSERT_MSG(size <= object_size, "%s allocator used for an object of %zu bytes", GetName(), size);
+
+    if (free_list == nullptr)
+        AddSlab();
+
+    FreeObject* object = free_list;
+    free_list = object->next;
+
+    ++num_allocations;
+    peak_live_objects = std::max(peak_live_objects, ++live_objects);
+    return object;
+}
+
+void SlabAllocator::Free(void* pointer) {
+    if (pointer == nullptr)
+        return;
+
+    FreeObject* object = static_cast<FreeObject*>(pointer);
+    object->next = free_list;
+    free_list = object;
+    --live_objects;
+}
+
+void SlabAllocator::AddSlab() {
+    // Objects are kept aligned for any type, as the ones given by operator new
+    const size_t alignment = alignof(std::max_align_t);
+    const size_t stride = (object_size + alignment - 1) / alignment * alignment;
+
+    u8* slab = new u8[stride * OBJECTS_PER_SLAB];
+    slabs.emplace_back(slab);
+
+    // Link the objects in address order, so that they are handed out in that order
+    for (size_t i = OBJECTS_PER_SLAB; i-- > 0;) {
+        FreeObject* object = reinterpret_cast<FreeObject*>(slab + i * stride);
+        object->next = free_list;
+        free_list = object;
+    }
+}
+
+const char* SlabAllocator::GetName() const {
+    switch (type) {
+    case HandleType::Port:           return "Port";
+    case HandleType::Session:        return "Session";
+    case HandleType::Event:          return "Event";
+    case HandleType::Mutex:          return "Mutex";
+    case HandleType::SharedMemory:   return "SharedMemory";
+    case HandleType::Redirection:    return "Redirection";
+    case HandleType::Thread:         return "Thread";
+    case HandleType::Process:        return "Process";
+    case HandleType::AddressArbiter: return "AddressArbiter";
+    case HandleType::Semaphore:      return "Semaphore";
+    case HandleType::Timer:          return "Timer";
+    case HandleType::ResourceLimit:  return "ResourceLimit";
+    case HandleType::CodeSet:        return "CodeSet";
+    case HandleType::Unknown:        break;
+    }
+    return "Unknown";
+}
+
+std::vector<const SlabAllocator*> GetSlabAllocators() {
+    std::lock_guard<std::mutex> lock(allocators_mutex);
+    return allocators;
+}
+
+} // namespace
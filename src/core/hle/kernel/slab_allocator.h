@@ -0,0 +1,103 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+
+#include "core/hle/kernel/kernel.h"
+
+namespace Kernel {
+
+/**
+ * Allocator for the kernel objects of a single type. Memory is taken from the system in slabs of
+ * several objects, and freed objects are kept in an intrusive free list to be reused by the next
+ * allocation, so objects that are created and destroyed at a high rate don't go through malloc and
+ * stay close together in memory. Slabs are kept until the end of the program.
+ *
+ * The kernel objects are only created and destroyed from the emulation thread, so this isn't
+ * thread-safe. The statistics may be read from other threads while emulation is paused.
+ */
+class SlabAllocator : NonCopyable {
+public:
+    /**
+     * @param type Type of the objects, used to name the allocator in the debugger
+     * @param object_size Size of the objects in bytes
+     */
+    SlabAllocator(HandleType type, size_t object_size);
+
+    /// Allocates memory for one object, of the size the allocator was created with
+    void* Allocate(size_t size);
+
+    /// Frees the memory of an object allocated by this allocator
+    void Free(void* pointer);
+
+    /// Returns the name of the type of the objects
+    const char* GetName() const;
+
+    size_t GetObjectSize() const { return object_size; }
+    /// Returns the number of objects currently allocated
+    size_t GetNumLiveObjects() const { return live_objects; }
+    /// Returns the highest number of objects that have been allocated at the same time
+    size_t GetPeakLiveObjects() const { return peak_live_objects; }
+    /// Returns the number of objects the slabs can hold
+    size_t GetCapacity() const { return slabs.size() * OBJECTS_PER_SLAB; }
+    /// Returns the number of allocations done since the start of the program
+    u64 GetNumAllocations() const { return num_allocations; }
+
+private:
+    static const size_t OBJECTS_PER_SLAB = 64;
+
+    /// Freed objects are overwritten by the link to the next freed object
+    struct FreeObject {
+        FreeObject* next;
+    };
+
+    /// Allocates a new slab and adds its objects to the free list
+    void AddSlab();
+
+    HandleType type;
+    size_t object_size;
+
+    std::vector<std::unique_ptr<u8[]>> slabs;
+    FreeObject* free_list = nullptr;
+
+    size_t live_objects = 0;
+    size_t peak_live_objects = 0;
+    u64 num_allocations = 0;
+};
+
+/**
+ * Returns the slab allocators of the types of which objects have been created so far
+ */
+std::vector<const SlabAllocator*> GetSlabAllocators();
+
+/**
+ * Base class for kernel objects that are allocated from a SlabAllocator of their own. The type
+ * passes itself as T, and must have a HANDLE_TYPE.
+ */
+template <typename T>
+class SlabAllocated {
+public:
+    static void* operator new(size_t size) {
+        return GetSlabAllocator().Allocate(size);
+    }
+
+    static void operator delete(void* pointer) {
+        GetSlabAllocator().Free(pointer);
+    }
+
+private:
+    static SlabAllocator& GetSlabAllocator() {
+        // Never destroyed, as objects kept by static variables may be released at exit after it
+        static SlabAllocator& allocator = *new SlabAllocator(T::HANDLE_TYPE, sizeof(T));
+        return allocator;
+    }
+};
+
+} // namespace
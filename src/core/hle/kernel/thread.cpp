@@ -3,7 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <deque>
+#include <iterator>
 #include <list>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "common/assert.h"
@@ -48,6 +52,21 @@ static std::vector<SharedPtr<Thread>> thread_list;
 // Lists only ready thread ids.
 static Common::ThreadQueueList<Thread*, THREADPRIO_LOWEST+1> ready_queue;
 
+/// Orders threads by the tick they were last running at, and then by creation
+struct LastRunningOrder {
+    bool operator()(const Thread* a, const Thread* b) const {
+        if (a->last_running_ticks != b->last_running_ticks)
+            return a->last_running_ticks < b->last_running_ticks;
+        return a->thread_id < b->thread_id;
+    }
+};
+
+// Ready threads, with the ones that have gone without running the longest first. Threads are
+// removed from it when they start running, but it may still briefly contain threads that stopped
+// being ready otherwise, so users must check their status. A thread must be removed before its
+// last_running_ticks changes.
+static std::set<Thread*, LastRunningOrder> starvation_queue;
+
 static Thread* current_thread;
 
 // The first available thread id at startup
@@ -82,14 +101,60 @@ static bool CheckWait_WaitObject(const Thread* thread, WaitObject* wait_object)
     return itr != thread->wait_objects.end();
 }
 
+// Threads waiting on each arbitration address, ordered so that the next thread to be arbitrated
+// is at the front. Only threads with the THREADSTATUS_WAIT_ARB status are in these queues.
+// A thread resumed alone usually waits again at the front, and threads resumed together wait
+// again in about the order they were arbitrated in, close to the back. A deque inserts at either
+// end in constant time.
+static std::unordered_map<VAddr, std::deque<Thread*>> arbitration_queues;
+
 /**
- * Check if the specified thread is waiting on the specified address to be arbitrated
- * @param thread The thread to test
- * @param wait_address The address to test against
- * @return True if the thread is waiting, false otherwise
+ * Ordering of the arbitration queues. Threads of higher priority are arbitrated first, and among
+ * threads of equal priority the most recently created one is.
+ * @return True if thread `a` is arbitrated before thread `b`
  */
-static bool CheckWait_AddressArbiter(const Thread* thread, VAddr wait_address) {
-    return thread->status == THREADSTATUS_WAIT_ARB && wait_address == thread->wait_address;
+static bool IsArbitratedBefore(const Thread* a, const Thread* b) {
+    if (a->current_priority != b->current_priority)
+        return a->current_priority < b->current_priority;
+    return a->thread_id > b->thread_id;
+}
+
+/**
+ * Adds a thread to the arbitration queue of its wait address
+ * @param thread The thread to add, which must be waiting on an address arbiter
+ */
+static void AddArbitrationWaiter(Thread* thread) {
+    auto& queue = arbitration_queues[thread->wait_address];
+
+    if (queue.empty() || IsArbitratedBefore(thread, queue.front())) {
+        queue.push_front(thread);
+        return;
+    }
+
+    // Otherwise the thread usually goes close to the back, behind the threads of higher priority
+    auto itr = queue.end();
+    while (IsArbitratedBefore(thread, *std::prev(itr)))
+        --itr;
+    queue.insert(itr, thread);
+}
+
+/**
+ * Removes a thread from the arbitration queue of its wait address, if it is in it
+ * @param thread The thread to remove
+ */
+static void RemoveArbitrationWaiter(Thread* thread) {
+    auto queue_itr = arbitration_queues.find(thread->wait_address);
+    if (queue_itr == arbitration_queues.end())
+        return;
+
+    // Search from the front, where the arbitrated threads are
+    auto& queue = queue_itr->second;
+    auto itr = std::find(queue.begin(), queue.end(), thread);
+    if (itr != queue.end())
+        queue.erase(itr);
+
+    if (queue.empty())
+        arbitration_queues.erase(queue_itr);
 }
 
 void Thread::Stop() {
@@ -107,6 +172,11 @@ void Thread::Stop() {
         ready_queue.remove(current_priority, this);
     }
 
+    if (status == THREADSTATUS_WAIT_ARB)
+        RemoveArbitrationWaiter(this);
+
+    starvation_queue.erase(this);
+
     status = THREADSTATUS_DEAD;
 
     WakeupAllWaitingThreads();
@@ -125,59 +195,69 @@ void Thread::Stop() {
 }
 
 Thread* ArbitrateHighestPriorityThread(u32 address) {
-    Thread* highest_priority_thread = nullptr;
-    s32 priority = THREADPRIO_LOWEST;
-
-    // Iterate through threads, find highest priority thread that is waiting to be arbitrated...
-    for (auto& thread : thread_list) {
-        if (!CheckWait_AddressArbiter(thread.get(), address))
-            continue;
+    auto queue_itr = arbitration_queues.find(address);
+    if (queue_itr == arbitration_queues.end())
+        return nullptr;
 
-        if (thread == nullptr)
-            continue;
-
-        if(thread->current_priority <= priority) {
-            highest_priority_thread = thread.get();
-            priority = thread->current_priority;
-        }
-    }
-
-    // If a thread was arbitrated, resume it
-    if (nullptr != highest_priority_thread) {
-        highest_priority_thread->ResumeFromWait();
-    }
+    // Resuming the thread removes it from the queue
+    Thread* highest_priority_thread = queue_itr->second.front();
+    highest_priority_thread->ResumeFromWait();
 
     return highest_priority_thread;
 }
 
 void ArbitrateAllThreads(u32 address) {
-    // Resume all threads found to be waiting on the address
-    for (auto& thread : thread_list) {
-        if (CheckWait_AddressArbiter(thread.get(), address))
-            thread->ResumeFromWait();
+    auto queue_itr = arbitration_queues.find(address);
+    if (queue_itr == arbitration_queues.end())
+        return;
+
+    std::deque<Thread*> waiting_threads = std::move(queue_itr->second);
+    arbitration_queues.erase(queue_itr);
+
+    // Resume all threads found to be waiting on the address. Threads of the same priority are
+    // queued in descending thread id order, so going backwards readies them in the order they
+    // were created.
+    for (auto itr = waiting_threads.rbegin(); itr != waiting_threads.rend(); ++itr) {
+        (*itr)->ResumeFromWait();
     }
 }
 
 /// Boost low priority threads (temporarily) that have been starved
 static void PriorityBoostStarvedThreads() {
-    u64 current_ticks = CoreTiming::GetTicks();
+    // TODO(bunnei): Threads that have been waiting to be scheduled for `boost_ticks` (or
+    // longer) will have their priority temporarily adjusted to 1 higher than the highest
+    // priority thread to prevent thread starvation. This general behavior has been verified
+    // on hardware. However, this is almost certainly not perfect, and the real CTR OS scheduler
+    // should probably be reversed to verify this.
 
-    for (auto& thread : thread_list) {
-        // TODO(bunnei): Threads that have been waiting to be scheduled for `boost_ticks` (or
-        // longer) will have their priority temporarily adjusted to 1 higher than the highest
-        // priority thread to prevent thread starvation. This general behavior has been verified
-        // on hardware. However, this is almost certainly not perfect, and the real CTR OS scheduler
-        // should probably be reversed to verify this.
+    const u64 boost_timeout = 2000000;  // Boost threads that have been ready for > this long
 
-        const u64 boost_timeout = 2000000;  // Boost threads that have been ready for > this long
+    u64 current_ticks = CoreTiming::GetTicks();
 
-        u64 delta = current_ticks - thread->last_running_ticks;
+    // Only the front of the starvation queue can have been ready for long enough
+    std::vector<Thread*> starved_threads;
+    for (auto itr = starvation_queue.begin(); itr != starvation_queue.end();) {
+        Thread* thread = *itr;
+        if (current_ticks - thread->last_running_ticks <= boost_timeout)
+            break;
 
-        if (thread->status == THREADSTATUS_READY && delta > boost_timeout) {
-            const s32 priority = std::max(ready_queue.get_first()->current_priority - 1, 0);
-            thread->BoostPriority(priority);
+        if (thread->status == THREADSTATUS_READY) {
+            starved_threads.push_back(thread);
+            ++itr;
+        } else {
+            itr = starvation_queue.erase(itr);
         }
     }
+
+    // Boost them in creation order, as each boost is relative to the priorities of the previous ones
+    std::sort(starved_threads.begin(), starved_threads.end(), [](const Thread* a, const Thread* b) {
+        return a->thread_id < b->thread_id;
+    });
+
+    for (Thread* thread : starved_threads) {
+        const s32 priority = std::max(ready_queue.get_first()->current_priority - 1, 0);
+        thread->BoostPriority(priority);
+    }
 }
 
 /**
@@ -189,6 +269,7 @@ static void SwitchContext(Thread* new_thread) {
 
     // Save context for previous thread
     if (previous_thread) {
+        starvation_queue.erase(previous_thread);
         previous_thread->last_running_ticks = CoreTiming::GetTicks();
         Core::g_app_core->SaveContext(previous_thread->context);
 
@@ -198,6 +279,9 @@ static void SwitchContext(Thread* new_thread) {
             ready_queue.push_front(previous_thread->current_priority, previous_thread);
             previous_thread->status = THREADSTATUS_READY;
         }
+
+        if (previous_thread->status == THREADSTATUS_READY)
+            starvation_queue.insert(previous_thread);
     }
 
     // Load context of new thread
@@ -209,6 +293,13 @@ static void SwitchContext(Thread* new_thread) {
 
         current_thread = new_thread;
 
+        // Switch to the address space of the new thread's process. This only swaps the page table.
+        Memory::PageTable* page_table = &new_thread->owner_process->vm_manager.page_table;
+        if (page_table != Memory::current_page_table) {
+            g_current_process = new_thread->owner_process;
+            Memory::SetCurrentPageTable(page_table);
+        }
+
         // If the thread was waited by a svcWaitSynch call, step back PC by one instruction to rerun
         // the SVC when the thread wakes up. This is necessary to ensure that the thread can acquire
         // the requested wait object(s) before continuing.
@@ -222,13 +313,13 @@ static void SwitchContext(Thread* new_thread) {
 
         // Clean up the thread's wait_objects, they'll be restored if needed during
         // the svcWaitSynchronization call
-        for (size_t i = 0; i < new_thread->wait_objects.size(); ++i) {
-            SharedPtr<WaitObject> object = new_thread->wait_objects[i];
+        for (auto& object : new_thread->wait_objects) {
             object->RemoveWaitingThread(new_thread);
         }
         new_thread->wait_objects.clear();
 
         ready_queue.remove(new_thread->current_priority, new_thread);
+        starvation_queue.erase(new_thread);
         new_thread->status = THREADSTATUS_RUNNING;
 
         // Restores thread to its nominal priority if it has been temporarily changed
@@ -271,11 +362,10 @@ void WaitCurrentThread_Sleep() {
     HLE::Reschedule(__func__);
 }
 
-void WaitCurrentThread_WaitSynchronization(std::vector<SharedPtr<WaitObject>> wait_objects, bool wait_set_output, bool wait_all) {
+void WaitCurrentThread_WaitSynchronization(bool wait_set_output, bool wait_all) {
     Thread* thread = GetCurrentThread();
     thread->wait_set_output = wait_set_output;
     thread->wait_all = wait_all;
-    thread->wait_objects = std::move(wait_objects);
     thread->waitsynch_waited = true;
     thread->status = THREADSTATUS_WAIT_SYNCH;
 }
@@ -284,6 +374,7 @@ void WaitCurrentThread_ArbitrateAddress(VAddr wait_address) {
     Thread* thread = GetCurrentThread();
     thread->wait_address = wait_address;
     thread->status = THREADSTATUS_WAIT_ARB;
+    AddArbitrationWaiter(thread);
 }
 
 /**
@@ -322,8 +413,11 @@ void Thread::WakeAfterDelay(s64 nanoseconds) {
 
 void Thread::ResumeFromWait() {
     switch (status) {
-        case THREADSTATUS_WAIT_SYNCH:
         case THREADSTATUS_WAIT_ARB:
+            RemoveArbitrationWaiter(this);
+            break;
+
+        case THREADSTATUS_WAIT_SYNCH:
         case THREADSTATUS_WAIT_SLEEP:
             break;
 
@@ -345,6 +439,7 @@ void Thread::ResumeFromWait() {
 
     ready_queue.push_back(current_priority, this);
     status = THREADSTATUS_READY;
+    starvation_queue.insert(this);
 }
 
 /**
@@ -387,7 +482,6 @@ ResultVal<SharedPtr<Thread>> Thread::Create(std::string name, VAddr entry_point,
     SharedPtr<Thread> thread(new Thread);
 
     thread_list.push_back(thread);
-    ready_queue.prepare(priority);
 
     thread->thread_id = NewThreadId();
     thread->status = THREADSTATUS_DORMANT;
@@ -426,6 +520,7 @@ ResultVal<SharedPtr<Thread>> Thread::Create(std::string name, VAddr entry_point,
 
     ready_queue.push_back(thread->current_priority, thread.get());
     thread->status = THREADSTATUS_READY;
+    starvation_queue.insert(thread.get());
 
     HLE::Reschedule(__func__);
 
@@ -449,18 +544,31 @@ static void ClampPriority(const Thread* thread, s32* priority) {
 void Thread::SetPriority(s32 priority) {
     ClampPriority(this, &priority);
 
+    // The arbitration queues are ordered by priority, so reinsert the thread if it is waiting
+    const bool waiting_arbitration = status == THREADSTATUS_WAIT_ARB;
+    if (waiting_arbitration)
+        RemoveArbitrationWaiter(this);
+
     // If thread was ready, adjust queues
     if (status == THREADSTATUS_READY)
         ready_queue.move(this, current_priority, priority);
-    else
-        ready_queue.prepare(priority);
 
     nominal_priority = current_priority = priority;
+
+    if (waiting_arbitration)
+        AddArbitrationWaiter(this);
 }
 
 void Thread::BoostPriority(s32 priority) {
+    const bool waiting_arbitration = status == THREADSTATUS_WAIT_ARB;
+    if (waiting_arbitration)
+        RemoveArbitrationWaiter(this);
+
     ready_queue.move(this, current_priority, priority);
     current_priority = priority;
+
+    if (waiting_arbitration)
+        AddArbitrationWaiter(this);
 }
 
 SharedPtr<Thread> SetupMainThread(u32 entry_point, s32 priority) {
@@ -529,6 +637,8 @@ void ThreadingShutdown() {
     }
     thread_list.clear();
     ready_queue.clear();
+    starvation_queue.clear();
+    arbitration_queues.clear();
 }
 
 } // namespace
@@ -4,17 +4,21 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <string>
 #include <vector>
 
 #include <boost/container/flat_set.hpp>
 
+#include "common/assert.h"
 #include "common/common_types.h"
 
 #include "core/core.h"
 
 #include "core/hle/hle.h"
 #include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/slab_allocator.h"
 #include "core/hle/result.h"
 
 enum ThreadPriority : s32{
@@ -47,7 +51,46 @@ namespace Kernel {
 class Mutex;
 class Process;
 
-class Thread final : public WaitObject {
+/// Maximum number of objects a thread can wait on at once, as limited by svcWaitSynchronizationN
+const size_t MAX_WAIT_OBJECTS = 256;
+
+/**
+ * List of the objects a thread is waiting on. It is stored inline in the thread with room for the
+ * most objects a thread can wait on, so that waiting doesn't allocate.
+ */
+class WaitObjectList {
+public:
+    typedef SharedPtr<WaitObject>* iterator;
+    typedef const SharedPtr<WaitObject>* const_iterator;
+
+    void push_back(SharedPtr<WaitObject> object) {
+        ASSERT_MSG(count < objects.size(), "too many wait objects");
+        objects[count++] = std::move(object);
+    }
+
+    void clear() {
+        for (size_t i = 0; i < count; ++i)
+            objects[i] = nullptr;
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    SharedPtr<WaitObject>& operator[](size_t index) { return objects[index]; }
+    const SharedPtr<WaitObject>& operator[](size_t index) const { return objects[index]; }
+
+    iterator begin() { return objects.data(); }
+    iterator end() { return objects.data() + count; }
+    const_iterator begin() const { return objects.data(); }
+    const_iterator end() const { return objects.data() + count; }
+
+private:
+    std::array<SharedPtr<WaitObject>, MAX_WAIT_OBJECTS> objects;
+    size_t count = 0;
+};
+
+class Thread final : public WaitObject, public SlabAllocated<Thread> {
 public:
     /**
      * Creates and returns a new thread. The new thread is immediately scheduled
@@ -152,7 +195,7 @@ public:
     boost::container::flat_set<SharedPtr<Mutex>> held_mutexes;
 
     SharedPtr<Process> owner_process; ///< Process that owns this thread
-    std::vector<SharedPtr<WaitObject>> wait_objects; ///< Objects that the thread is waiting on
+    WaitObjectList wait_objects; ///< Objects that the thread is waiting on
     VAddr wait_address;     ///< If waiting on an AddressArbiter, this is the arbitration address
     bool wait_all;          ///< True if the thread is waiting on all objects before resuming
     bool wait_set_output;   ///< True if the output parameter should be set on thread wakeup
@@ -203,12 +246,12 @@ Thread* GetCurrentThread();
 void WaitCurrentThread_Sleep();
 
 /**
- * Waits the current thread from a WaitSynchronization call
- * @param wait_objects Kernel objects that we are waiting on
+ * Waits the current thread from a WaitSynchronization call. The objects it waits on must already
+ * have been added to its wait_objects.
  * @param wait_set_output If true, set the output parameter on thread wakeup (for WaitSynchronizationN only)
  * @param wait_all If true, wait on all objects before resuming (for WaitSynchronizationN only)
  */
-void WaitCurrentThread_WaitSynchronization(std::vector<SharedPtr<WaitObject>> wait_objects, bool wait_set_output, bool wait_all);
+void WaitCurrentThread_WaitSynchronization(bool wait_set_output, bool wait_all);
 
 /**
  * Waits the current thread from an ArbitrateAddress call
@@ -45,12 +45,18 @@ VMManager::VMManager() {
 }
 
 VMManager::~VMManager() {
+    if (Memory::current_page_table == &page_table)
+        Memory::SetCurrentPageTable(nullptr);
     Reset();
 }
 
 void VMManager::Reset() {
     vma_map.clear();
 
+    page_table.pointers.fill(nullptr);
+    page_table.attributes.fill(Memory::PageType::Unmapped);
+    Memory::ClearCodeCache(page_table);
+
     // Initialize the map with a single free region covering the entire managed space.
     VirtualMemoryArea initial_vma;
     initial_vma.size = MAX_ADDRESS;
@@ -321,17 +327,17 @@ VMManager::VMAIter VMManager::MergeAdjacent(VMAIter iter) {
 void VMManager::UpdatePageTableForVMA(const VirtualMemoryArea& vma) {
     switch (vma.type) {
     case VMAType::Free:
-        Memory::UnmapRegion(vma.base, vma.size);
+        Memory::UnmapRegion(page_table, vma.base, vma.size);
         break;
     case VMAType::AllocatedMemoryBlock:
-        Memory::MapMemoryRegion(vma.base, vma.size, vma.backing_block->data() + vma.offset);
+        Memory::MapMemoryRegion(page_table, vma.base, vma.size, vma.backing_block->data() + vma.offset);
         break;
     case VMAType::BackingMemory:
-        Memory::MapMemoryRegion(vma.base, vma.size, vma.backing_memory);
+        Memory::MapMemoryRegion(page_table, vma.base, vma.size, vma.backing_memory);
         break;
     case VMAType::MMIO:
         // TODO(yuriks): Add support for MMIO handlers.
-        Memory::MapIoRegion(vma.base, vma.size);
+        Memory::MapIoRegion(page_table, vma.base, vma.size);
         break;
     }
 }
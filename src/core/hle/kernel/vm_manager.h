@@ -10,6 +10,7 @@
 
 #include "common/common_types.h"
 
+#include "core/memory.h"
 #include "core/hle/result.h"
 
 namespace Kernel {
@@ -110,7 +111,6 @@ struct VirtualMemoryArea {
  *  - http://duartes.org/gustavo/blog/post/page-cache-the-affair-between-memory-and-files/
  */
 class VMManager final {
-    // TODO(yuriks): Make page tables switchable to support multiple VMManagers
 public:
     /**
      * The maximum amount of address space managed by the kernel. Addresses above this are never used.
@@ -128,6 +128,12 @@ public:
     std::map<VAddr, VirtualMemoryArea> vma_map;
     using VMAHandle = decltype(vma_map)::const_iterator;
 
+    /**
+     * Page table of the address space, kept in sync with `vma_map`. It is made the current page
+     * table when a thread of the owning process is scheduled.
+     */
+    Memory::PageTable page_table;
+
     VMManager();
     ~VMManager();
 
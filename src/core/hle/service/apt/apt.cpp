@@ -216,7 +216,7 @@ void ReceiveParameter(Service::Interface* self) {
     cmd_buff[8] = buffer;
 
     if (next_parameter.data)
-        memcpy(Memory::GetPointer(buffer), next_parameter.data, std::min(buffer_size, next_parameter.buffer_size));
+        Memory::WriteBlock(buffer, next_parameter.data, std::min(buffer_size, next_parameter.buffer_size));
 
     LOG_WARNING(Service_APT, "called app_id=0x%08X, buffer_size=0x%08X", app_id, buffer_size);
 }
@@ -239,7 +239,7 @@ void GlanceParameter(Service::Interface* self) {
     cmd_buff[8] = buffer;
 
     if (next_parameter.data)
-        memcpy(Memory::GetPointer(buffer), next_parameter.data, std::min(buffer_size, next_parameter.buffer_size));
+        Memory::WriteBlock(buffer, next_parameter.data, std::min(buffer_size, next_parameter.buffer_size));
 
     LOG_WARNING(Service_APT, "called app_id=0x%08X, buffer_size=0x%08X", app_id, buffer_size);
 }
@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <vector>
+
 #include "common/logging/log.h"
 
+#include "core/memory.h"
 #include "core/hle/hle.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/service/dsp_dsp.h"
@@ -219,15 +222,17 @@ static void ReadPipeIfPossible(Service::Interface* self) {
 
     u32 initial_size = read_pipe_count;
 
+    std::vector<u16> pipe_data;
     for (unsigned offset = 0; offset < size; offset += sizeof(u16)) {
         if (read_pipe_count < canned_read_pipe.size()) {
-            Memory::Write16(addr + offset, canned_read_pipe[read_pipe_count]);
+            pipe_data.push_back(canned_read_pipe[read_pipe_count]);
             read_pipe_count++;
         } else {
             LOG_ERROR(Service_DSP, "canned read pipe log exceeded!");
             break;
         }
     }
+    Memory::WriteBlock(addr, pipe_data.data(), pipe_data.size() * sizeof(u16));
 
     cmd_buff[1] = 0; // No error
     cmd_buff[2] = (read_pipe_count - initial_size) * sizeof(u16);
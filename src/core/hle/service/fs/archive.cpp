@@ -105,12 +105,22 @@ ResultVal<bool> File::SyncRequest() {
                       GetTypeName().c_str(), GetName().c_str(), offset, length, address);
             if (offset + length > backend->GetSize())
                 LOG_ERROR(Service_FS, "Reading from out of bounds offset=0x%llX length=0x%08X file_size=0x%llX", offset, length, backend->GetSize());
-            ResultVal<size_t> read = backend->Read(offset, length, Memory::GetPointer(address));
-            if (read.Failed()) {
-                cmd_buff[1] = read.Code().raw;
-                return read.Code();
+            // The file is read straight into the guest buffer, a run of contiguous host memory at a time
+            ResultCode result = RESULT_SUCCESS;
+            const size_t read = Memory::AccessBlock(address, length, true,
+                    [&](u8* buffer, size_t size, size_t buffer_offset) -> size_t {
+                ResultVal<size_t> run_read = backend->Read(offset + buffer_offset, size, buffer);
+                if (run_read.Failed()) {
+                    result = run_read.Code();
+                    return 0;
+                }
+                return *run_read;
+            });
+            if (result.IsError()) {
+                cmd_buff[1] = result.raw;
+                return result;
             }
-            cmd_buff[2] = static_cast<u32>(read.MoveFrom());
+            cmd_buff[2] = static_cast<u32>(read);
             break;
         }
 
@@ -124,12 +134,21 @@ ResultVal<bool> File::SyncRequest() {
             LOG_TRACE(Service_FS, "Write %s %s: offset=0x%llx length=%d address=0x%x, flush=0x%x",
                       GetTypeName().c_str(), GetName().c_str(), offset, length, address, flush);
 
-            ResultVal<size_t> written = backend->Write(offset, length, flush != 0, Memory::GetPointer(address));
-            if (written.Failed()) {
-                cmd_buff[1] = written.Code().raw;
-                return written.Code();
+            ResultCode result = RESULT_SUCCESS;
+            const size_t written = Memory::AccessBlock(address, length, false,
+                    [&](u8* buffer, size_t size, size_t buffer_offset) -> size_t {
+                ResultVal<size_t> run_written = backend->Write(offset + buffer_offset, size, flush != 0, buffer);
+                if (run_written.Failed()) {
+                    result = run_written.Code();
+                    return 0;
+                }
+                return *run_written;
+            });
+            if (result.IsError()) {
+                cmd_buff[1] = result.raw;
+                return result;
             }
-            cmd_buff[2] = static_cast<u32>(written.MoveFrom());
+            cmd_buff[2] = static_cast<u32>(written);
             break;
         }
 
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <vector>
+
 #include "common/bit_field.h"
 #include "common/microprofile.h"
 
@@ -67,7 +69,8 @@ static inline InterruptRelayQueue* GetInterruptRelayQueue(u32 thread_id) {
  */
 static bool CheckWriteParameters(u32 base_address, u32 size_in_bytes) {
     // TODO: Return proper error codes
-    if (base_address + size_in_bytes >= 0x420000) {
+    // Compared so that a guest-supplied size can't wrap the end address around
+    if (size_in_bytes >= 0x420000 || base_address >= 0x420000 - size_in_bytes) {
         LOG_ERROR(Service_GSP, "Write address out of range! (address=0x%08x, size=0x%08x)",
                   base_address, size_in_bytes);
         return false;
@@ -118,9 +121,14 @@ static void WriteHWRegs(Service::Interface* self) {
     u32 reg_addr = cmd_buff[1];
     u32 size = cmd_buff[2];
 
-    u32* src = (u32*)Memory::GetPointer(cmd_buff[4]);
+    // The size is checked before it is used to allocate the buffer
+    if (!CheckWriteParameters(reg_addr, size))
+        return;
+
+    std::vector<u32> src(size / 4);
+    Memory::ReadBlock(cmd_buff[4], src.data(), size);
 
-    WriteHWRegs(reg_addr, size, src);
+    WriteHWRegs(reg_addr, size, src.data());
 }
 
 /**
@@ -171,10 +179,16 @@ static void WriteHWRegsWithMask(Service::Interface* self) {
     u32 reg_addr = cmd_buff[1];
     u32 size = cmd_buff[2];
 
-    u32* src_data = (u32*)Memory::GetPointer(cmd_buff[4]);
-    u32* mask_data = (u32*)Memory::GetPointer(cmd_buff[6]);
+    // The size is checked before it is used to allocate the buffers
+    if (!CheckWriteParameters(reg_addr, size))
+        return;
+
+    std::vector<u32> src_data(size / 4);
+    std::vector<u32> mask_data(size / 4);
+    Memory::ReadBlock(cmd_buff[4], src_data.data(), size);
+    Memory::ReadBlock(cmd_buff[6], mask_data.data(), size);
 
-    WriteHWRegsWithMask(reg_addr, size, src_data, mask_data);
+    WriteHWRegsWithMask(reg_addr, size, src_data.data(), mask_data.data());
 }
 
 /// Read a GSP GPU hardware register
@@ -184,7 +198,7 @@ static void ReadHWRegs(Service::Interface* self) {
     u32 size = cmd_buff[2];
 
     // TODO: Return proper error codes
-    if (reg_addr + size >= 0x420000) {
+    if (size >= 0x420000 || reg_addr >= 0x420000 - size) {
         LOG_ERROR(Service_GSP, "Read address out of range! (address=0x%08x, size=0x%08x)", reg_addr, size);
         return;
     }
@@ -195,15 +209,13 @@ static void ReadHWRegs(Service::Interface* self) {
         return;
     }
 
-    u32* dst = (u32*)Memory::GetPointer(cmd_buff[0x41]);
-
-    while (size > 0) {
-        HW::Read<u32>(*dst, reg_addr + REGS_BEGIN);
-
-        size -= 4;
-        ++dst;
+    std::vector<u32> dst(size / 4);
+    for (u32& value : dst) {
+        HW::Read<u32>(value, reg_addr + REGS_BEGIN);
         reg_addr += 4;
     }
+
+    Memory::WriteBlock(cmd_buff[0x41], dst.data(), size);
 }
 
 void SetBufferSwap(u32 screen_id, const FrameBufferInfo& info) {
@@ -368,9 +380,8 @@ static void ExecuteCommand(const Command& command, u32 thread_id) {
         VideoCore::g_renderer->rasterizer->FlushRegion(Memory::VirtualToPhysicalAddress(command.dma_request.source_address),
                                                             command.dma_request.size);
 
-        memcpy(Memory::GetPointer(command.dma_request.dest_address),
-               Memory::GetPointer(command.dma_request.source_address),
-               command.dma_request.size);
+        Memory::CopyBlock(command.dma_request.dest_address, command.dma_request.source_address,
+                          command.dma_request.size);
         SignalInterrupt(InterruptId::DMA);
 
         VideoCore::g_renderer->rasterizer->InvalidateRegion(Memory::VirtualToPhysicalAddress(command.dma_request.dest_address),
@@ -240,7 +240,9 @@ static ResultCode WaitSynchronization1(Handle handle, s64 nano_seconds) {
     if (object->ShouldWait()) {
 
         object->AddWaitingThread(thread);
-        Kernel::WaitCurrentThread_WaitSynchronization({ object }, false, false);
+        thread->wait_objects.clear();
+        thread->wait_objects.push_back(std::move(object));
+        Kernel::WaitCurrentThread_WaitSynchronization(false, false);
 
         // Create an event to wake the thread up after the specified nanosecond delay has passed
         thread->WakeAfterDelay(nano_seconds);
@@ -271,20 +273,31 @@ static ResultCode WaitSynchronizationN(s32* out, Handle* handles, s32 handle_cou
     ASSERT_MSG(out != nullptr, "invalid output pointer specified!");
 
     // Check if 'handle_count' is invalid
-    if (handle_count < 0)
+    if (handle_count < 0 || handle_count > static_cast<s32>(Kernel::MAX_WAIT_OBJECTS))
         return ResultCode(ErrorDescription::OutOfRange, ErrorModule::OS, ErrorSummary::InvalidArgument, ErrorLevel::Usage);
 
+    // The objects are looked up once, straight into the wait list of the thread. The list is
+    // cleared again if the thread doesn't end up waiting.
+    auto& wait_objects = thread->wait_objects;
+    wait_objects.clear();
+
     // If 'handle_count' is non-zero, iterate through each handle and wait the current thread if
     // necessary
     if (handle_count != 0) {
         bool selected = false; // True once an object has been selected
 
-        Kernel::SharedPtr<Kernel::WaitObject> wait_object;
+        Kernel::WaitObject* wait_object = nullptr;
 
         for (int i = 0; i < handle_count; ++i) {
             auto object = Kernel::g_handle_table.GetWaitObject(handles[i]);
-            if (object == nullptr)
+            if (object == nullptr) {
+                wait_objects.clear();
                 return ERR_INVALID_HANDLE;
+            }
+
+            // Once an object has been selected the thread won't wait, so the following objects
+            // are only validated
+            const bool keep_object = wait_all || !selected;
 
             // Check if the current thread should wait on this object...
             if (object->ShouldWait()) {
@@ -299,10 +312,13 @@ static ResultCode WaitSynchronizationN(s32* out, Handle* handles, s32 handle_cou
                     // Do not wait the thread
                     wait_thread = false;
                     handle_index = i;
-                    wait_object = object;
+                    wait_object = object.get();
                     selected = true;
                 }
             }
+
+            if (keep_object)
+                wait_objects.push_back(std::move(object));
         }
     } else {
         // If no handles were passed in, put the thread to sleep only when 'wait_all' is false
@@ -318,16 +334,11 @@ static ResultCode WaitSynchronizationN(s32* out, Handle* handles, s32 handle_cou
     if (wait_thread) {
 
         // Actually wait the current thread on each object if we decided to wait...
-        std::vector<SharedPtr<Kernel::WaitObject>> wait_objects;
-        wait_objects.reserve(handle_count);
-
-        for (int i = 0; i < handle_count; ++i) {
-            auto object = Kernel::g_handle_table.GetWaitObject(handles[i]);
-            object->AddWaitingThread(Kernel::GetCurrentThread());
-            wait_objects.push_back(object);
+        for (auto& object : wait_objects) {
+            object->AddWaitingThread(thread);
         }
 
-        Kernel::WaitCurrentThread_WaitSynchronization(std::move(wait_objects), true, wait_all);
+        Kernel::WaitCurrentThread_WaitSynchronization(true, wait_all);
 
         // Create an event to wake the thread up after the specified nanosecond delay has passed
         Kernel::GetCurrentThread()->WakeAfterDelay(nano_seconds);
@@ -337,9 +348,7 @@ static ResultCode WaitSynchronizationN(s32* out, Handle* handles, s32 handle_cou
     }
 
     // Acquire objects if we did not wait...
-    for (int i = 0; i < handle_count; ++i) {
-        auto object = Kernel::g_handle_table.GetWaitObject(handles[i]);
-
+    for (auto& object : wait_objects) {
         // Acquire the object if it is not waiting...
         if (!object->ShouldWait()) {
             object->Acquire();
@@ -350,6 +359,7 @@ static ResultCode WaitSynchronizationN(s32* out, Handle* handles, s32 handle_cou
                 break;
         }
     }
+    wait_objects.clear();
 
     // TODO(bunnei): If 'wait_all' is true, this is probably wrong. However, real hardware does
     // not seem to set it to any meaningful value.
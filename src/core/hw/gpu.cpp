@@ -141,6 +141,7 @@ inline void Write(u32 addr, const T data) {
                     GSP_GPU::SignalInterrupt(GSP_GPU::InterruptId::PSC1);
                 }
 
+                Memory::MarkRegionModified(config.GetStartAddress(), config.GetEndAddress() - config.GetStartAddress());
                 VideoCore::g_renderer->rasterizer->InvalidateRegion(config.GetStartAddress(), config.GetEndAddress() - config.GetStartAddress());
             }
 
@@ -205,6 +206,7 @@ inline void Write(u32 addr, const T data) {
                     config.flags);
 
                 size_t contiguous_output_size = config.texture_copy.size / output_width * (output_width + output_gap);
+                Memory::MarkRegionModified(config.GetPhysicalOutputAddress(), contiguous_output_size);
                 VideoCore::g_renderer->rasterizer->InvalidateRegion(config.GetPhysicalOutputAddress(), contiguous_output_size);
 
                 GSP_GPU::SignalInterrupt(GSP_GPU::InterruptId::PPF);
@@ -339,6 +341,7 @@ inline void Write(u32 addr, const T data) {
             g_regs.display_transfer_config.trigger = 0;
             GSP_GPU::SignalInterrupt(GSP_GPU::InterruptId::PPF);
 
+            Memory::MarkRegionModified(config.GetPhysicalOutputAddress(), output_size);
             VideoCore::g_renderer->rasterizer->InvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
         }
         break;
@@ -6,6 +6,7 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <vector>
 
 #include "common/assert.h"
 #include "common/color.h"
@@ -84,18 +85,22 @@ static void ConvertYUVToRGB(InputFormat input_format,
 /// Simulates an incoming CDMA transfer. The N parameter is used to automatically convert 16-bit formats to 8-bit.
 template <size_t N>
 static void ReceiveData(u8* output, ConversionBuffer& buf, size_t amount_of_data) {
-    const u8* input = Memory::GetPointer(buf.address);
+    std::vector<u8> input(buf.transfer_unit);
 
     size_t output_unit = buf.transfer_unit / N;
     ASSERT(amount_of_data % output_unit == 0);
 
     while (amount_of_data > 0) {
-        for (size_t i = 0; i < output_unit; ++i) {
-            output[i] = input[i * N];
+        if (N == 1) {
+            Memory::ReadBlock(buf.address, output, output_unit);
+        } else {
+            Memory::ReadBlock(buf.address, input.data(), buf.transfer_unit);
+            for (size_t i = 0; i < output_unit; ++i) {
+                output[i] = input[i * N];
+            }
         }
 
         output += output_unit;
-        input += buf.transfer_unit + buf.gap;
 
         buf.address += buf.transfer_unit + buf.gap;
         buf.image_size -= buf.transfer_unit;
@@ -107,9 +112,13 @@ static void ReceiveData(u8* output, ConversionBuffer& buf, size_t amount_of_data
 static void SendData(const u32* input, ConversionBuffer& buf, int amount_of_data,
         OutputFormat output_format, u8 alpha) {
 
-    u8* output = Memory::GetPointer(buf.address);
+    // Each transfer unit is encoded into a local buffer and then written out in one go. The last
+    // pixel of a unit may run past its end, so leave room for one more pixel.
+    std::vector<u8> unit(buf.transfer_unit + 4);
+    VAddr output_address = buf.address;
 
     while (amount_of_data > 0) {
+        u8* output = unit.data();
         u8* unit_end = output + buf.transfer_unit;
         while (output < unit_end) {
             u32 color = *input++;
@@ -139,7 +148,10 @@ static void SendData(const u32* input, ConversionBuffer& buf, int amount_of_data
             amount_of_data -= 1;
         }
 
-        output += buf.gap;
+        const size_t unit_size = output - unit.data();
+        Memory::WriteBlock(output_address, unit.data(), unit_size);
+
+        output_address += static_cast<VAddr>(unit_size + buf.gap);
         buf.address += buf.transfer_unit + buf.gap;
         buf.image_size -= buf.transfer_unit;
     }
@@ -2,57 +2,76 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <cstring>
+#include <functional>
 
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "common/swap.h"
 
+#include "core/core.h"
+#include "core/arm/arm_interface.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
 #include "core/memory_setup.h"
 
 namespace Memory {
 
-enum class PageType {
-    /// Page is unmapped and should cause an access error.
-    Unmapped,
-    /// Page is mapped to regular memory. This is the only type you can get pointers to.
-    Memory,
-    /// Page is mapped to a I/O region. Writing and reading to this page is handled by functions.
-    Special,
-};
+PageTable* current_page_table = nullptr;
+
+/// Discards the translated code of the given page of an address space if there is any
+static void InvalidateCodePage(PageTable& page_table, u32 page) {
+    if (!page_table.cached_code[page])
+        return;
+
+    page_table.cached_code[page] = false;
+
+    // The cores keep the code of every address space, not only the current one
+    const VAddr addr = page << PAGE_BITS;
+    if (Core::g_app_core)
+        Core::g_app_core->InvalidateCodePage(page_table, addr);
+    if (Core::g_sys_core)
+        Core::g_sys_core->InvalidateCodePage(page_table, addr);
+}
+
+/// Generation stored into the tracked pages written to from now on
+static u32 write_generation = 1;
+/// Generation of the last write to each FCRAM page, see GetWriteGeneration
+static std::array<u32, FCRAM_SIZE / PAGE_SIZE> fcram_page_generations;
+/// Generation of the last write to each VRAM page
+static std::array<u32, VRAM_SIZE / PAGE_SIZE> vram_page_generations;
 
 /**
- * A (reasonably) fast way of allowing switchable and remappable process address spaces. It loosely
- * mimics the way a real CPU page table works, but instead is optimized for minimal decoding and
- * fetching requirements when accessing. In the usual case of an access to regular memory, it only
- * requires an indexed fetch and a check for NULL.
+ * Gets the write generation entry of the physical page containing the given address.
+ * @return Pointer to the entry, or nullptr if writes to the page are not tracked
  */
-struct PageTable {
-    static const size_t NUM_ENTRIES = 1 << (32 - PAGE_BITS);
-
-    /**
-     * Array of memory pointers backing each page. An entry can only be non-null if the
-     * corresponding entry in the `attributes` array is of type `Memory`.
-     */
-    std::array<u8*, NUM_ENTRIES> pointers;
-
-    /**
-     * Array of fine grained page attributes. If it is set to any value other than `Memory`, then
-     * the corresponding entry in `pointer` MUST be set to null.
-     */
-    std::array<PageType, NUM_ENTRIES> attributes;
-};
-
-/// Singular page table used for the singleton process
-static PageTable main_page_table;
-/// Currently active page table
-static PageTable* current_page_table = &main_page_table;
-
-static void MapPages(u32 base, u32 size, u8* memory, PageType type) {
+static u32* GetPageGeneration(PAddr addr) {
+    if (addr >= FCRAM_PADDR && addr < FCRAM_PADDR_END)
+        return &fcram_page_generations[(addr - FCRAM_PADDR) >> PAGE_BITS];
+    if (addr >= VRAM_PADDR && addr < VRAM_PADDR_END)
+        return &vram_page_generations[(addr - VRAM_PADDR) >> PAGE_BITS];
+    return nullptr;
+}
+
+/**
+ * Records a CPU write to the given virtual page. Only the regions that map linearly to physical
+ * memory are tracked, since those are the only ones the GPU can be pointed at.
+ */
+static void MarkVirtualPageModified(u32 page) {
+    const VAddr addr = page << PAGE_BITS;
+    if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END) {
+        fcram_page_generations[(addr - LINEAR_HEAP_VADDR) >> PAGE_BITS] = write_generation;
+    } else if (addr >= VRAM_VADDR && addr < VRAM_VADDR_END) {
+        vram_page_generations[(addr - VRAM_VADDR) >> PAGE_BITS] = write_generation;
+    } else if (addr >= NEW_LINEAR_HEAP_VADDR && addr < NEW_LINEAR_HEAP_VADDR + FCRAM_SIZE) {
+        fcram_page_generations[(addr - NEW_LINEAR_HEAP_VADDR) >> PAGE_BITS] = write_generation;
+    }
+}
+
+static void MapPages(PageTable& page_table, u32 base, u32 size, u8* memory, PageType type) {
     LOG_DEBUG(HW_Memory, "Mapping %p onto %08X-%08X", memory, base * PAGE_SIZE, (base + size) * PAGE_SIZE);
 
     u32 end = base + size;
@@ -60,8 +79,9 @@ static void MapPages(u32 base, u32 size, u8* memory, PageType type) {
     while (base != end) {
         ASSERT_MSG(base < PageTable::NUM_ENTRIES, "out of range mapping at %08X", base);
 
-        current_page_table->attributes[base] = type;
-        current_page_table->pointers[base] = memory;
+        InvalidateCodePage(page_table, base);
+        page_table.attributes[base] = type;
+        page_table.pointers[base] = memory;
 
         base += 1;
         if (memory != nullptr)
@@ -70,30 +90,47 @@ static void MapPages(u32 base, u32 size, u8* memory, PageType type) {
 }
 
 void InitMemoryMap() {
-    main_page_table.pointers.fill(nullptr);
-    main_page_table.attributes.fill(PageType::Unmapped);
+    current_page_table = nullptr;
+
+    write_generation = 1;
+    fcram_page_generations.fill(0);
+    vram_page_generations.fill(0);
 }
 
-void MapMemoryRegion(VAddr base, u32 size, u8* target) {
+void SetCurrentPageTable(PageTable* page_table) {
+    current_page_table = page_table;
+}
+
+void ClearCodeCache(PageTable& page_table) {
+    page_table.cached_code.reset();
+
+    if (Core::g_app_core)
+        Core::g_app_core->ClearInstructionCache(page_table);
+    if (Core::g_sys_core)
+        Core::g_sys_core->ClearInstructionCache(page_table);
+}
+
+void MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, u8* target) {
     ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: %08X", size);
     ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: %08X", base);
-    MapPages(base / PAGE_SIZE, size / PAGE_SIZE, target, PageType::Memory);
+    MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, target, PageType::Memory);
 }
 
-void MapIoRegion(VAddr base, u32 size) {
+void MapIoRegion(PageTable& page_table, VAddr base, u32 size) {
     ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: %08X", size);
     ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: %08X", base);
-    MapPages(base / PAGE_SIZE, size / PAGE_SIZE, nullptr, PageType::Special);
+    MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, nullptr, PageType::Special);
 }
 
-void UnmapRegion(VAddr base, u32 size) {
+void UnmapRegion(PageTable& page_table, VAddr base, u32 size) {
     ASSERT_MSG((size & PAGE_MASK) == 0, "non-page aligned size: %08X", size);
     ASSERT_MSG((base & PAGE_MASK) == 0, "non-page aligned base: %08X", base);
-    MapPages(base / PAGE_SIZE, size / PAGE_SIZE, nullptr, PageType::Unmapped);
+    MapPages(page_table, base / PAGE_SIZE, size / PAGE_SIZE, nullptr, PageType::Unmapped);
 }
 
 template <typename T>
 T Read(const VAddr vaddr) {
+    DEBUG_ASSERT_MSG(current_page_table != nullptr, "Read%lu @ 0x%08X without an address space", sizeof(T) * 8, vaddr);
     const u8* page_pointer = current_page_table->pointers[vaddr >> PAGE_BITS];
     if (page_pointer) {
         T value;
@@ -118,9 +155,12 @@ T Read(const VAddr vaddr) {
 
 template <typename T>
 void Write(const VAddr vaddr, const T data) {
+    DEBUG_ASSERT_MSG(current_page_table != nullptr, "Write%lu @ 0x%08X without an address space", sizeof(T) * 8, vaddr);
     u8* page_pointer = current_page_table->pointers[vaddr >> PAGE_BITS];
     if (page_pointer) {
         std::memcpy(&page_pointer[vaddr & PAGE_MASK], &data, sizeof(T));
+        InvalidateCodePage(*current_page_table, vaddr >> PAGE_BITS);
+        MarkVirtualPageModified(vaddr >> PAGE_BITS);
         return;
     }
 
@@ -140,6 +180,7 @@ void Write(const VAddr vaddr, const T data) {
 }
 
 u8* GetPointer(const VAddr vaddr) {
+    ASSERT_MSG(current_page_table != nullptr, "GetPointer @ 0x%08X without an address space", vaddr);
     u8* page_pointer = current_page_table->pointers[vaddr >> PAGE_BITS];
     if (page_pointer) {
         return page_pointer + (vaddr & PAGE_MASK);
@@ -149,6 +190,20 @@ u8* GetPointer(const VAddr vaddr) {
     return nullptr;
 }
 
+void FlagCodePage(const VAddr addr) {
+    current_page_table->cached_code[addr >> PAGE_BITS] = true;
+}
+
+void InvalidateCodeRange(const VAddr start, const u32 size) {
+    if (size == 0)
+        return;
+
+    const u32 first_page = start >> PAGE_BITS;
+    const u32 last_page = (start + size - 1) >> PAGE_BITS;
+    for (u32 page = first_page; page <= last_page; ++page)
+        InvalidateCodePage(*current_page_table, page);
+}
+
 u8* GetPhysicalPointer(PAddr address) {
     return GetPointer(PhysicalToVirtualAddress(address));
 }
@@ -185,10 +240,167 @@ void Write64(const VAddr addr, const u64 data) {
     Write<u64_le>(addr, data);
 }
 
-void WriteBlock(const VAddr addr, const u8* data, const size_t size) {
-    for (u32 offset = 0; offset < size; offset++) {
-        Write8(addr + offset, data[offset]);
+/**
+ * Calls the given function for every page touched by a block access, passing the page number, the
+ * offset of the access within the page, the number of bytes accessed in the page and the offset
+ * of those bytes within the block. Blocks running past the end of the address space wrap around to
+ * its start, like the guest addresses do.
+ */
+template <typename Func>
+static void WalkBlock(const VAddr addr, const size_t size, Func&& func) {
+    size_t remaining_size = size;
+    size_t page_index = addr >> PAGE_BITS;
+    size_t page_offset = addr & PAGE_MASK;
+
+    while (remaining_size > 0) {
+        const size_t copy_amount = std::min<size_t>(PAGE_SIZE - page_offset, remaining_size);
+        func(page_index, page_offset, copy_amount, size - remaining_size);
+
+        page_index = (page_index + 1) & (PageTable::NUM_ENTRIES - 1);
+        page_offset = 0;
+        remaining_size -= copy_amount;
+    }
+}
+
+void ReadBlock(const VAddr src_addr, void* dest_buffer, const size_t size) {
+    WalkBlock(src_addr, size, [&](size_t page_index, size_t page_offset, size_t copy_amount, size_t block_offset) {
+        u8* dest_ptr = static_cast<u8*>(dest_buffer) + block_offset;
+        const u8* src_ptr = current_page_table->pointers[page_index];
+        if (src_ptr) {
+            std::memcpy(dest_ptr, src_ptr + page_offset, copy_amount);
+            return;
+        }
+
+        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
+        LOG_ERROR(HW_Memory, "unmapped ReadBlock @ 0x%08X (start address = 0x%08X, size = %zu)",
+                  current_vaddr, src_addr, size);
+        std::memset(dest_ptr, 0, copy_amount);
+    });
+}
+
+void WriteBlock(const VAddr dest_addr, const void* src_buffer, const size_t size) {
+    WalkBlock(dest_addr, size, [&](size_t page_index, size_t page_offset, size_t copy_amount, size_t block_offset) {
+        const u8* src_ptr = static_cast<const u8*>(src_buffer) + block_offset;
+        u8* dest_ptr = current_page_table->pointers[page_index];
+        if (dest_ptr) {
+            std::memcpy(dest_ptr + page_offset, src_ptr, copy_amount);
+            InvalidateCodePage(*current_page_table, static_cast<u32>(page_index));
+            MarkVirtualPageModified(static_cast<u32>(page_index));
+            return;
+        }
+
+        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
+        LOG_ERROR(HW_Memory, "unmapped WriteBlock @ 0x%08X (start address = 0x%08X, size = %zu)",
+                  current_vaddr, dest_addr, size);
+    });
+}
+
+void ZeroBlock(const VAddr dest_addr, const size_t size) {
+    WalkBlock(dest_addr, size, [&](size_t page_index, size_t page_offset, size_t copy_amount, size_t) {
+        u8* dest_ptr = current_page_table->pointers[page_index];
+        if (dest_ptr) {
+            std::memset(dest_ptr + page_offset, 0, copy_amount);
+            InvalidateCodePage(*current_page_table, static_cast<u32>(page_index));
+            MarkVirtualPageModified(static_cast<u32>(page_index));
+            return;
+        }
+
+        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
+        LOG_ERROR(HW_Memory, "unmapped ZeroBlock @ 0x%08X (start address = 0x%08X, size = %zu)",
+                  current_vaddr, dest_addr, size);
+    });
+}
+
+void CopyBlock(const VAddr dest_addr, const VAddr src_addr, const size_t size) {
+    // Walk the source pages and write each run to the destination, which may itself cross pages at
+    // different offsets. Unmapped source pages are copied as zeroes.
+    WalkBlock(src_addr, size, [&](size_t page_index, size_t page_offset, size_t copy_amount, size_t block_offset) {
+        const VAddr current_dest = static_cast<VAddr>(dest_addr + block_offset);
+        const u8* src_ptr = current_page_table->pointers[page_index];
+        if (src_ptr) {
+            WriteBlock(current_dest, src_ptr + page_offset, copy_amount);
+            return;
+        }
+
+        const VAddr current_vaddr = static_cast<VAddr>((page_index << PAGE_BITS) + page_offset);
+        LOG_ERROR(HW_Memory, "unmapped CopyBlock @ 0x%08X (start address = 0x%08X, size = %zu)",
+                  current_vaddr, src_addr, size);
+        ZeroBlock(current_dest, copy_amount);
+    });
+}
+
+size_t AccessBlock(const VAddr addr, const size_t size, const bool write,
+                   const std::function<size_t(u8*, size_t, size_t)>& func) {
+    size_t done = 0;
+    while (done < size) {
+        const VAddr run_addr = static_cast<VAddr>(addr + done);
+        u32 page = run_addr >> PAGE_BITS;
+        u8* page_pointer = current_page_table->pointers[page];
+        if (page_pointer == nullptr) {
+            LOG_ERROR(HW_Memory, "unmapped AccessBlock @ 0x%08X (start address = 0x%08X, size = %zu)",
+                      run_addr, addr, size);
+            break;
+        }
+        u8* const run_pointer = page_pointer + (run_addr & PAGE_MASK);
+
+        // Extend the run over the following pages for as long as they follow it in host memory
+        size_t run_size = std::min<size_t>(PAGE_SIZE - (run_addr & PAGE_MASK), size - done);
+        while (done + run_size < size) {
+            const u32 next_page = (page + 1) & (PageTable::NUM_ENTRIES - 1);
+            if (current_page_table->pointers[next_page] != page_pointer + PAGE_SIZE)
+                break;
+
+            page = next_page;
+            page_pointer += PAGE_SIZE;
+            run_size += std::min<size_t>(PAGE_SIZE, size - done - run_size);
+        }
+
+        const size_t run_done = std::min(func(run_pointer, run_size, done), run_size);
+
+        if (write && run_done != 0) {
+            const u32 num_pages = static_cast<u32>(((run_addr & PAGE_MASK) + run_done + PAGE_MASK) >> PAGE_BITS);
+            for (u32 i = 0; i < num_pages; ++i) {
+                const u32 written_page = ((run_addr >> PAGE_BITS) + i) & (PageTable::NUM_ENTRIES - 1);
+                InvalidateCodePage(*current_page_table, written_page);
+                MarkVirtualPageModified(written_page);
+            }
+        }
+
+        done += run_done;
+        if (run_done < run_size)
+            break;
+    }
+    return done;
+}
+
+u32 GetWriteGeneration() {
+    return write_generation++;
+}
+
+void MarkRegionModified(const PAddr start, const u32 size) {
+    if (size == 0)
+        return;
+
+    const u32 last_page = (start + size - 1) >> PAGE_BITS;
+    for (u32 page = start >> PAGE_BITS; page <= last_page; ++page) {
+        u32* generation = GetPageGeneration(page << PAGE_BITS);
+        if (generation != nullptr)
+            *generation = write_generation;
+    }
+}
+
+bool IsRegionModified(const PAddr start, const u32 size, const u32 generation) {
+    if (size == 0)
+        return false;
+
+    const u32 last_page = (start + size - 1) >> PAGE_BITS;
+    for (u32 page = start >> PAGE_BITS; page <= last_page; ++page) {
+        const u32* page_generation = GetPageGeneration(page << PAGE_BITS);
+        // Untracked pages can't be proven to be unmodified
+        if (page_generation == nullptr || *page_generation > generation)
+            return true;
     }
+    return false;
 }
 
 PAddr VirtualToPhysicalAddress(const VAddr addr) {
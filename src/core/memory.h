@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <cstddef>
+#include <functional>
 
 #include "common/common_types.h"
 
@@ -116,6 +119,62 @@ enum : VAddr {
     NEW_LINEAR_HEAP_VADDR_END = NEW_LINEAR_HEAP_VADDR + NEW_LINEAR_HEAP_SIZE,
 };
 
+enum class PageType {
+    /// Page is unmapped and should cause an access error.
+    Unmapped,
+    /// Page is mapped to regular memory. This is the only type you can get pointers to.
+    Memory,
+    /// Page is mapped to a I/O region. Writing and reading to this page is handled by functions.
+    Special,
+};
+
+/**
+ * A (reasonably) fast way of allowing switchable and remappable process address spaces. It loosely
+ * mimics the way a real CPU page table works, but instead is optimized for minimal decoding and
+ * fetching requirements when accessing. In the usual case of an access to regular memory, it only
+ * requires an indexed fetch and a check for NULL.
+ */
+struct PageTable {
+    static const size_t NUM_ENTRIES = 1 << (32 - PAGE_BITS);
+
+    /**
+     * Array of memory pointers backing each page. An entry can only be non-null if the
+     * corresponding entry in the `attributes` array is of type `Memory`.
+     */
+    std::array<u8*, NUM_ENTRIES> pointers;
+
+    /**
+     * Array of fine grained page attributes. If it is set to any value other than `Memory`, then
+     * the corresponding entry in `pointer` MUST be set to null.
+     */
+    std::array<PageType, NUM_ENTRIES> attributes;
+
+    /**
+     * Bitmap of pages holding code that has been translated by a CPU core. Writing to or remapping
+     * one of these pages invalidates the translated code.
+     */
+    std::bitset<NUM_ENTRIES> cached_code;
+};
+
+/// Page table of the address space of the running process, or nullptr if there is none
+extern PageTable* current_page_table;
+
+/**
+ * Makes the given page table the one used by all memory accesses. The cores keep the code they
+ * translated from each address space apart, keyed by its page table, so switching back to an address
+ * space reuses its code instead of translating it again. Writes only invalidate the code of the
+ * address space they are made through, so code in memory shared between processes is not tracked
+ * across them.
+ */
+void SetCurrentPageTable(PageTable* page_table);
+
+/**
+ * Discards the code the cores translated from the given address space. This has to be called before
+ * its page table is reset or destroyed, as the cores would otherwise keep the code of the address
+ * space around and reuse it for a new page table allocated at the same address.
+ */
+void ClearCodeCache(PageTable& page_table);
+
 u8 Read8(VAddr addr);
 u16 Read16(VAddr addr);
 u32 Read32(VAddr addr);
@@ -126,10 +185,74 @@ void Write16(VAddr addr, u16 data);
 void Write32(VAddr addr, u32 data);
 void Write64(VAddr addr, u64 data);
 
-void WriteBlock(VAddr addr, const u8* data, size_t size);
+/**
+ * Copies a block of guest memory into a host buffer. The block may span multiple pages, which are
+ * copied a whole page at a time. Unmapped pages read as zero.
+ */
+void ReadBlock(VAddr src_addr, void* dest_buffer, size_t size);
+
+/**
+ * Copies a host buffer into guest memory, a whole page at a time. Writes to unmapped pages are
+ * dropped.
+ */
+void WriteBlock(VAddr dest_addr, const void* src_buffer, size_t size);
+
+/// Fills a block of guest memory with zeroes, a whole page at a time
+void ZeroBlock(VAddr dest_addr, size_t size);
+
+/**
+ * Copies a block of guest memory to another guest address. The source and destination must not
+ * overlap.
+ */
+void CopyBlock(VAddr dest_addr, VAddr src_addr, size_t size);
+
+/**
+ * Gives direct access to the host memory backing a block of guest memory, for transfers between
+ * guest buffers and host files that shouldn't go through a temporary copy. The block is split into
+ * runs of pages that are contiguous in host memory, and the function is called for each one in
+ * order with a pointer to the run, its size and its offset within the block. It returns the number
+ * of bytes it transferred, and the walk stops after a short transfer or at an unmapped page.
+ * @param write Whether the function writes to the memory, which then invalidates translated code
+ *              and records the write like WriteBlock does
+ * @return Number of bytes transferred
+ */
+size_t AccessBlock(VAddr addr, size_t size, bool write,
+                   const std::function<size_t(u8* pointer, size_t size, size_t block_offset)>& func);
 
 u8* GetPointer(VAddr virtual_address);
 
+/**
+ * Flags the page containing the given address as holding guest code translated by a CPU core.
+ * Writes to a flagged page through the Memory functions invalidate the translated code.
+ */
+void FlagCodePage(VAddr addr);
+
+/**
+ * Invalidates any translated code in the given range. This has to be called after modifying guest
+ * code through a pointer obtained from GetPointer.
+ */
+void InvalidateCodeRange(VAddr start, u32 size);
+
+/**
+ * Gets the current write generation of physical memory and starts a new one. Writes to FCRAM and
+ * VRAM through the Memory functions, and the ones reported with MarkRegionModified, record the
+ * generation they happened in for each page. A consumer that caches data derived from guest memory
+ * keeps the value returned here and checks it with IsRegionModified, instead of rehashing the data.
+ */
+u32 GetWriteGeneration();
+
+/**
+ * Records a write to the given physical range that did not go through the Memory functions, such
+ * as one done by an emulated hardware engine through a physical pointer.
+ */
+void MarkRegionModified(PAddr start, u32 size);
+
+/**
+ * Checks whether the given physical range may have been written to since the given generation was
+ * returned by GetWriteGeneration. This only takes time linear in the number of pages in the range.
+ */
+bool IsRegionModified(PAddr start, u32 size, u32 generation);
+
 /**
 * Converts a virtual address inside a region with 1:1 mapping to physical memory to a physical
 * address. This should be used by services to translate addresses for use by the hardware.
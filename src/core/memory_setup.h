@@ -15,19 +15,20 @@ void InitMemoryMap();
 /**
  * Maps an allocated buffer onto a region of the emulated process address space.
  *
+ * @param page_table The page table of the address space to map into.
  * @param base The address to start mapping at. Must be page-aligned.
  * @param size The amount of bytes to map. Must be page-aligned.
  * @param target Buffer with the memory backing the mapping. Must be of length at least `size`.
  */
-void MapMemoryRegion(VAddr base, u32 size, u8* target);
+void MapMemoryRegion(PageTable& page_table, VAddr base, u32 size, u8* target);
 
 /**
  * Maps a region of the emulated process address space as a IO region.
  * @note Currently this can only be used to mark a region as being IO, since actual memory-mapped
  *       IO isn't yet supported.
  */
-void MapIoRegion(VAddr base, u32 size);
+void MapIoRegion(PageTable& page_table, VAddr base, u32 size);
 
-void UnmapRegion(VAddr base, u32 size);
+void UnmapRegion(PageTable& page_table, VAddr base, u32 size);
 
 }
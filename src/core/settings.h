@@ -45,6 +45,7 @@ struct Values {
 
     // Core
     int frame_skip;
+    bool use_cpu_jit;
 
     // Data Storage
     bool use_virtual_sd;
@@ -65,6 +66,9 @@ struct Values {
     // Debugging
     bool use_gdbstub;
     u16 gdbstub_port;
+    bool use_block_profiler;
+    bool use_perf_map;
+    bool use_jitdump;
 } extern values;
 
 }
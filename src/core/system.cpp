@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/jit_profiling.h"
+
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/settings.h"
 #include "core/system.h"
 #include "core/hw/hw.h"
 #include "core/hle/hle.h"
@@ -17,6 +20,7 @@
 namespace System {
 
 void Init(EmuWindow* emu_window) {
+    JitProfiling::Init(Settings::values.use_perf_map, Settings::values.use_jitdump);
     Core::Init();
     CoreTiming::Init();
     Memory::Init();
@@ -35,6 +39,7 @@ void Shutdown() {
     HW::Shutdown();
     CoreTiming::Shutdown();
     Core::Shutdown();
+    JitProfiling::Shutdown();
 }
 
 } // namespace
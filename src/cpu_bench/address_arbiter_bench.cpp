@@ -0,0 +1,105 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+
+#include "common/common_types.h"
+#include "common/make_unique.h"
+
+#include "core/core.h"
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/skyeye_common/armstate.h"
+#include "core/hle/kernel/address_arbiter.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/thread.h"
+
+#include "cpu_bench/address_arbiter_bench.h"
+#include "cpu_bench/kernel_setup.h"
+
+// The main thread signals the arbiter, like a game releasing a lightweight event or semaphore that
+// its worker threads wait on, and then sleeps. The resumed threads are switched to one after the
+// other, and each waits on the address again, until none is left ready and the main thread resumes.
+// The waiters have spread priorities, all lower than the main thread's. Apart from arbitration, each
+// round trip of a thread includes its two context switches.
+
+static const int NUM_WAITERS[] = { 16, 64, 128, 256 };
+static const s32 MAIN_THREAD_PRIORITY = 0x18;
+/// Number of threads resumed per run of each workload
+static const u64 NUM_RESUMED = 500000;
+
+static Kernel::SharedPtr<Kernel::AddressArbiter> arbiter;
+static Kernel::SharedPtr<Kernel::Thread> main_thread;
+
+/// Puts the main thread to sleep, lets the ready threads wait on the arbiter again, and resumes the main thread
+static void WaitReadyThreads() {
+    Kernel::WaitCurrentThread_Sleep();
+    Kernel::Reschedule();
+
+    // The value at the address is 0, so waiting if it is less than 1 always waits
+    while (Kernel::GetCurrentThread() != nullptr) {
+        arbiter->ArbitrateAddress(Kernel::ArbitrationType::WaitIfLessThan, BENCH_DATA_VADDR, 1, 0);
+        Kernel::Reschedule();
+    }
+
+    main_thread->ResumeFromWait();
+    Kernel::Reschedule();
+}
+
+/**
+ * Signals the arbiter until NUM_RESUMED threads have been resumed
+ * @param num_waiters Number of threads waiting on the arbiter
+ * @param signal_value Number of threads resumed per signal, or -1 to resume all of them
+ * @return The time taken
+ */
+static double RunSignals(int num_waiters, s32 signal_value) {
+    main_thread = InitBenchKernel(MAIN_THREAD_PRIORITY);
+    arbiter = Kernel::AddressArbiter::Create("Bench");
+    for (int i = 0; i < num_waiters; ++i)
+        CreateBenchThread(0x20 + (i * 7) % 0x20);
+    WaitReadyThreads();
+
+    const u64 resumed_per_signal = signal_value < 0 ? num_waiters : signal_value;
+    const u64 num_signals = NUM_RESUMED / resumed_per_signal;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    for (u64 i = 0; i < num_signals; ++i) {
+        arbiter->ArbitrateAddress(Kernel::ArbitrationType::Signal, BENCH_DATA_VADDR, signal_value, 0);
+        WaitReadyThreads();
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+
+    arbiter = nullptr;
+    main_thread = nullptr;
+    ShutdownBenchKernel();
+    return std::chrono::duration<double>(end_time - start_time).count() * NUM_RESUMED /
+           (num_signals * resumed_per_signal);
+}
+
+static void RunBest(const char* workload, int num_waiters, s32 signal_value, int num_repeats) {
+    double best = 0.0;
+    for (int i = 0; i < num_repeats; ++i) {
+        const double seconds = RunSignals(num_waiters, signal_value);
+        if (i == 0 || seconds < best)
+            best = seconds;
+    }
+
+    std::printf("%s,%d,%llu,%.6f,%.3f\n", workload, num_waiters, static_cast<unsigned long long>(NUM_RESUMED),
+                best, best * 1e9 / NUM_RESUMED);
+    std::fflush(stdout);
+}
+
+int RunAddressArbiterBenchmark(int num_repeats) {
+    // The kernel saves and loads the thread contexts through the application core
+    Core::g_app_core = Common::make_unique<ARM_DynCom>(USER32MODE);
+
+    std::printf("workload,waiters,resumed,seconds,ns_per_resumed_thread\n");
+    for (int num_waiters : NUM_WAITERS)
+        RunBest("signal-one", num_waiters, 1, num_repeats);
+    for (int num_waiters : NUM_WAITERS)
+        RunBest("signal-all", num_waiters, -1, num_repeats);
+
+    Core::g_app_core = nullptr;
+    return 0;
+}
@@ -0,0 +1,14 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+/**
+ * Times the signalling of an address arbiter with tens to hundreds of threads waiting on the same
+ * address, resuming either the highest priority waiter or all of them, until each resumed thread
+ * waits again. The results are written to stdout as CSV.
+ * @param num_repeats Number of runs per workload, the fastest one is reported
+ * @return 0 on success
+ */
+int RunAddressArbiterBenchmark(int num_repeats);
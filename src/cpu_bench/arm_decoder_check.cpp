@@ -0,0 +1,110 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+
+#include "core/arm/dyncom/arm_dyncom_dec.h"
+
+#include "cpu_bench/arm_decoder_check.h"
+
+// The decode table is indexed by bits [27:20] and [7:4] of the instructions. Every possible value of
+// these bits is combined with every condition and with several values of the remaining bits, among
+// which all zeroes and all ones, so that every list of candidates of the table is tested.
+
+static const u32 KEY_BITS_MASK = 0x0FF000F0;
+static const u32 OTHER_BITS_MASK = 0x000FFF0F;
+static const int NUM_DECODE_KEYS = 1 << 12;
+static const int VARIANTS_PER_KEY = 64;
+
+static std::vector<u32> GenerateInstructions() {
+    std::mt19937 rng(1);
+
+    std::vector<u32> instructions;
+    instructions.reserve(NUM_DECODE_KEYS * 16 * VARIANTS_PER_KEY + 1);
+    for (u32 key = 0; key < NUM_DECODE_KEYS; key++) {
+        const u32 key_bits = (((key >> 4) << 20) | ((key & 0xF) << 4)) & KEY_BITS_MASK;
+        for (u32 cond = 0; cond < 16; cond++) {
+            for (int variant = 0; variant < VARIANTS_PER_KEY; variant++) {
+                u32 other_bits;
+                if (variant == 0)
+                    other_bits = 0;
+                else if (variant == 1)
+                    other_bits = OTHER_BITS_MASK;
+                else
+                    other_bits = rng() & OTHER_BITS_MASK;
+                instructions.push_back((cond << 28) | key_bits | other_bits);
+            }
+        }
+    }
+    // clrex is matched on the whole instruction
+    instructions.push_back(0xF57FF01F);
+    return instructions;
+}
+
+/// Decodes all the instructions, storing the index of each one or -1 if it couldn't be decoded
+template <typename Decoder>
+static double Decode(const std::vector<u32>& instructions, std::vector<s32>& indices, Decoder decoder) {
+    const auto start_time = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < instructions.size(); i++) {
+        s32 idx;
+        indices[i] = (decoder(instructions[i], &idx) == ARMDecodeStatus::SUCCESS) ? idx : -1;
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end_time - start_time).count();
+}
+
+template <typename Decoder>
+static double DecodeBest(const std::vector<u32>& instructions, std::vector<s32>& indices,
+                         Decoder decoder, int num_repeats) {
+    double best = 0.0;
+    for (int i = 0; i < num_repeats; ++i) {
+        const double seconds = Decode(instructions, indices, decoder);
+        if (i == 0 || seconds < best)
+            best = seconds;
+    }
+    return best;
+}
+
+static void PrintResult(const char* decoder, size_t num_instructions, double seconds) {
+    std::printf("%s,%zu,%.6f,%.3f\n", decoder, num_instructions, seconds,
+                seconds * 1e9 / num_instructions);
+    std::fflush(stdout);
+}
+
+int RunARMDecoderCheck(int num_repeats) {
+    const std::vector<u32> instructions = GenerateInstructions();
+    std::vector<s32> scan_indices(instructions.size());
+    std::vector<s32> table_indices(instructions.size());
+
+    std::printf("decoder,instructions,seconds,ns_per_instruction\n");
+
+    PrintResult("scan", instructions.size(),
+                DecodeBest(instructions, scan_indices, DecodeARMInstructionByScan, num_repeats));
+    PrintResult("table", instructions.size(),
+                DecodeBest(instructions, table_indices, DecodeARMInstruction, num_repeats));
+
+    size_t num_mismatches = 0;
+    for (size_t i = 0; i < instructions.size(); i++) {
+        if (scan_indices[i] == table_indices[i])
+            continue;
+
+        // Only the first few are logged, a broken table usually gets whole keys wrong
+        if (num_mismatches++ < 16) {
+            LOG_ERROR(Frontend, "Decoding %08X gives %d through the table instead of %d",
+                      instructions[i], table_indices[i], scan_indices[i]);
+        }
+    }
+
+    if (num_mismatches != 0) {
+        LOG_CRITICAL(Frontend, "%zu instructions were decoded differently by the table", num_mismatches);
+        return -1;
+    }
+    return 0;
+}
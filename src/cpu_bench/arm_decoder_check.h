@@ -0,0 +1,14 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+/**
+ * Checks that decoding ARM instructions through the decode table gives the same results as scanning
+ * the whole instruction table, over every decode key, and compares the speed of both. The timings
+ * are written to stdout as CSV.
+ * @param num_repeats Number of runs per decoder, the fastest one is reported
+ * @return 0 on success, non-zero if the decoders disagreed on an instruction
+ */
+int RunARMDecoderCheck(int num_repeats);
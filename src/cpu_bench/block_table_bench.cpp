@@ -0,0 +1,131 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+
+#include "core/arm/block_table.h"
+
+#include "cpu_bench/block_table_bench.h"
+
+// The workload mimics the dispatch loop of the interpreter: the code is split into many small blocks
+// that all end in a conditional branch to one of two other blocks, and every block is looked up by
+// its address before it is run. The index found by a lookup selects the next block, so lookups can't
+// be overlapped with each other any more than in the interpreter.
+
+static const u32 CODE_BASE = 0x00100000;
+static const u32 CODE_SIZE = 4 * 1024 * 1024;
+static const int NUM_BLOCKS = 16 * 1024;
+static const u64 NUM_DISPATCHES = 50000000;
+
+struct Workload {
+    /// Guest address of every block
+    std::vector<u32> addresses;
+    /// Index of the block run after each block when its branch is taken or not taken
+    std::vector<int> taken;
+    std::vector<int> not_taken;
+};
+
+static Workload GenerateWorkload() {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<u32> word(0, CODE_SIZE / 4 - 1);
+    std::uniform_int_distribution<int> block(0, NUM_BLOCKS - 1);
+
+    Workload workload;
+    std::vector<bool> used(CODE_SIZE / 4);
+    while (workload.addresses.size() < NUM_BLOCKS) {
+        const u32 index = word(rng);
+        if (used[index])
+            continue;
+        used[index] = true;
+        workload.addresses.push_back(CODE_BASE + index * 4);
+        workload.taken.push_back(block(rng));
+        workload.not_taken.push_back(block(rng));
+    }
+    return workload;
+}
+
+struct Result {
+    double seconds;
+    /// Sum of the block indices found, to check that both containers agree
+    u64 checksum;
+};
+
+template <typename Lookup>
+static Result RunDispatches(const Workload& workload, Lookup lookup) {
+    // The branches are decided by a xorshift generator, which is cheaper than the lookups measured
+    u32 branch_state = 0x12345678;
+    int block = 0;
+
+    Result result;
+    result.checksum = 0;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    for (u64 i = 0; i < NUM_DISPATCHES; ++i) {
+        const int found = lookup(workload.addresses[block]);
+        result.checksum += found;
+
+        branch_state ^= branch_state << 13;
+        branch_state ^= branch_state >> 17;
+        branch_state ^= branch_state << 5;
+        block = (branch_state & 1) ? workload.taken[found] : workload.not_taken[found];
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+
+    result.seconds = std::chrono::duration<double>(end_time - start_time).count();
+    return result;
+}
+
+template <typename Lookup>
+static Result RunBest(const Workload& workload, Lookup lookup, int num_repeats) {
+    Result best = {};
+    for (int i = 0; i < num_repeats; ++i) {
+        const Result result = RunDispatches(workload, lookup);
+        if (i == 0 || result.seconds < best.seconds)
+            best = result;
+    }
+    return best;
+}
+
+static void PrintResult(const char* container, const Result& result) {
+    std::printf("%s,%llu,%.6f,%.3f\n", container, static_cast<unsigned long long>(NUM_DISPATCHES),
+                result.seconds, result.seconds * 1e9 / NUM_DISPATCHES);
+    std::fflush(stdout);
+}
+
+int RunBlockTableBenchmark(int num_repeats) {
+    const Workload workload = GenerateWorkload();
+
+    std::unordered_map<u32, int> map;
+    BlockTable<int> table(-1);
+    for (int i = 0; i < NUM_BLOCKS; ++i) {
+        map[workload.addresses[i]] = i;
+        table.Insert(workload.addresses[i], i);
+    }
+
+    std::printf("container,lookups,seconds,ns_per_lookup\n");
+
+    const Result map_result = RunBest(workload, [&map](u32 addr) {
+        auto it = map.find(addr);
+        return it != map.end() ? it->second : -1;
+    }, num_repeats);
+    PrintResult("unordered_map", map_result);
+
+    const Result table_result = RunBest(workload, [&table](u32 addr) {
+        return table.Find(addr);
+    }, num_repeats);
+    PrintResult("block_table", table_result);
+
+    if (map_result.checksum != table_result.checksum) {
+        LOG_CRITICAL(Frontend, "The block table and the map found different blocks");
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,13 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+/**
+ * Compares the cost of looking up translated blocks in a BlockTable against the std::unordered_map
+ * it replaced, on a synthetic branch-heavy workload. The results are written to stdout as CSV.
+ * @param num_repeats Number of runs per container, the fastest one is reported
+ * @return 0 on success, non-zero if the containers disagreed on a lookup
+ */
+int RunBlockTableBenchmark(int num_repeats);
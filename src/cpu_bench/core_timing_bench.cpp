@@ -0,0 +1,174 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/make_unique.h"
+
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/skyeye_common/armstate.h"
+
+#include "cpu_bench/core_timing_bench.h"
+
+// The "fire" workload models the hardware timers and interrupts of a running game: every pending
+// event is periodic and reschedules itself from its callback. The CPU is pretended to run until
+// the next event before each call to Advance. The "unschedule" workload models timeouts that are
+// cancelled before they expire, like most thread wakeups: an event is scheduled between the pending
+// ones and then unscheduled. The "threadsafe" workload models the GPU and audio threads signalling
+// the CPU thread: several producer threads schedule events through ScheduleEvent_Threadsafe, with
+// a bounded number in flight, while the CPU thread fires them.
+
+static const int FIRE_PENDING[] = { 4, 16, 64, 256, 4096 };
+static const int UNSCHEDULE_PENDING[] = { 100, 1000, 10000 };
+static const int THREADSAFE_PRODUCERS[] = { 1, 2, 4, 8 };
+static const u64 NUM_FIRES = 2000000;
+static const u64 NUM_UNSCHEDULES = 2000000;
+static const u64 NUM_THREADSAFE_EVENTS = 1000000;
+static const int MAX_THREADSAFE_IN_FLIGHT = 256;
+
+static int periodic_event;
+static u64 num_fired;
+
+/// Period of a periodic event, spread so that the events fire in a changing order
+static s64 GetPeriod(u64 userdata) {
+    return 1000 + static_cast<s64>((userdata * 7919) % 4096);
+}
+
+static void PeriodicCallback(u64 userdata, int cycles_late) {
+    num_fired++;
+    CoreTiming::ScheduleEvent(GetPeriod(userdata) - cycles_late, periodic_event, userdata);
+}
+
+static void UnusedCallback(u64 userdata, int cycles_late) {
+}
+
+static std::atomic<int> threadsafe_in_flight;
+
+static void ThreadsafeCallback(u64 userdata, int cycles_late) {
+    num_fired++;
+    threadsafe_in_flight--;
+}
+
+/// Fires periodic events until NUM_FIRES have fired, and returns the time taken
+static double RunFires(int num_pending) {
+    CoreTiming::Init();
+    periodic_event = CoreTiming::RegisterEvent("Periodic", PeriodicCallback);
+    for (int i = 0; i < num_pending; ++i)
+        CoreTiming::ScheduleEvent(GetPeriod(i), periodic_event, i);
+    num_fired = 0;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    while (num_fired < NUM_FIRES) {
+        Core::g_app_core->down_count = 0;
+        CoreTiming::Advance();
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+
+    CoreTiming::Shutdown();
+    return std::chrono::duration<double>(end_time - start_time).count() * NUM_FIRES / num_fired;
+}
+
+/// Schedules and unschedules an event NUM_UNSCHEDULES times among pending events, and returns the time taken
+static double RunUnschedules(int num_pending) {
+    CoreTiming::Init();
+    const int pending_event = CoreTiming::RegisterEvent("Pending", UnusedCallback);
+    const int timeout_event = CoreTiming::RegisterEvent("Timeout", UnusedCallback);
+    const s64 max_delay = 1000000000;
+    for (int i = 0; i < num_pending; ++i)
+        CoreTiming::ScheduleEvent(static_cast<s64>(i) * max_delay / num_pending, pending_event, i);
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<s64> delay_dist(0, max_delay);
+    std::vector<s64> delays(1024);
+    for (s64& delay : delays)
+        delay = delay_dist(rng);
+
+    const auto start_time = std::chrono::steady_clock::now();
+    for (u64 i = 0; i < NUM_UNSCHEDULES; ++i) {
+        CoreTiming::ScheduleEvent(delays[i % delays.size()], timeout_event, i);
+        CoreTiming::UnscheduleEvent(timeout_event, i);
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+
+    CoreTiming::Shutdown();
+    return std::chrono::duration<double>(end_time - start_time).count();
+}
+
+/// Fires NUM_THREADSAFE_EVENTS events scheduled by num_producers threads, and returns the time taken
+static double RunThreadsafe(int num_producers) {
+    CoreTiming::Init();
+    const int threadsafe_event = CoreTiming::RegisterEvent("Threadsafe", ThreadsafeCallback);
+    num_fired = 0;
+    threadsafe_in_flight = 0;
+
+    const u64 events_per_producer = NUM_THREADSAFE_EVENTS / num_producers;
+    const u64 num_events = events_per_producer * num_producers;
+    std::atomic<bool> start(false);
+    std::vector<std::thread> producers;
+    for (int i = 0; i < num_producers; ++i) {
+        producers.emplace_back([&start, events_per_producer, threadsafe_event] {
+            while (!start.load())
+                std::this_thread::yield();
+            for (u64 j = 0; j < events_per_producer; ++j) {
+                while (threadsafe_in_flight.load(std::memory_order_relaxed) >= MAX_THREADSAFE_IN_FLIGHT)
+                    std::this_thread::yield();
+                threadsafe_in_flight++;
+                CoreTiming::ScheduleEvent_Threadsafe(0, threadsafe_event, j);
+            }
+        });
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    start = true;
+    while (num_fired < num_events) {
+        Core::g_app_core->down_count = 0;
+        CoreTiming::Advance();
+        if (threadsafe_in_flight.load(std::memory_order_relaxed) == 0)
+            std::this_thread::yield();
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+
+    for (std::thread& producer : producers)
+        producer.join();
+    CoreTiming::Shutdown();
+    return std::chrono::duration<double>(end_time - start_time).count() * NUM_THREADSAFE_EVENTS / num_events;
+}
+
+template <typename Run>
+static void RunBest(const char* workload, int num_pending, u64 num_operations, Run run, int num_repeats) {
+    double best = 0.0;
+    for (int i = 0; i < num_repeats; ++i) {
+        const double seconds = run(num_pending);
+        if (i == 0 || seconds < best)
+            best = seconds;
+    }
+
+    std::printf("%s,%d,%llu,%.6f,%.3f\n", workload, num_pending, static_cast<unsigned long long>(num_operations),
+                best, best * 1e9 / num_operations);
+    std::fflush(stdout);
+}
+
+int RunCoreTimingBenchmark(int num_repeats) {
+    // CoreTiming keeps its slice counter in the application core
+    Core::g_app_core = Common::make_unique<ARM_DynCom>(USER32MODE);
+
+    std::printf("workload,pending,operations,seconds,ns_per_operation\n");
+    for (int num_pending : FIRE_PENDING)
+        RunBest("fire", num_pending, NUM_FIRES, RunFires, num_repeats);
+    for (int num_pending : UNSCHEDULE_PENDING)
+        RunBest("unschedule", num_pending, NUM_UNSCHEDULES, RunUnschedules, num_repeats);
+    for (int num_producers : THREADSAFE_PRODUCERS)
+        RunBest("threadsafe", num_producers, NUM_THREADSAFE_EVENTS, RunThreadsafe, num_repeats);
+
+    Core::g_app_core = nullptr;
+    return 0;
+}
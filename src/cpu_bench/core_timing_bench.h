@@ -0,0 +1,16 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+/**
+ * Times the event queue of CoreTiming with a few to thousands of pending events, both firing
+ * periodic events that reschedule themselves and scheduling events that are unscheduled again,
+ * and times events scheduled by several producer threads at once.
+ * The results are written to stdout as CSV. For the threadsafe workload, the pending column is the
+ * number of producer threads.
+ * @param num_repeats Number of runs per workload, the fastest one is reported
+ * @return 0 on success
+ */
+int RunCoreTimingBenchmark(int num_repeats);
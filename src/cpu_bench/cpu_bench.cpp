@@ -0,0 +1,446 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// This needs to be included before getopt.h because the latter #defines symbols used by it
+#include "common/microprofile.h"
+
+#ifdef _MSC_VER
+#include <getopt.h>
+#else
+#include <unistd.h>
+#include <getopt.h>
+#endif
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/make_unique.h"
+
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+#include "core/arm/arm_interface.h"
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/skyeye_common/armstate.h"
+#ifdef ARCHITECTURE_x86_64
+#include "core/arm/jit_x64/arm_jit_x64.h"
+#endif
+
+#include "cpu_bench/address_arbiter_bench.h"
+#include "cpu_bench/arm_decoder_check.h"
+#include "cpu_bench/block_table_bench.h"
+#include "cpu_bench/core_timing_bench.h"
+#ifdef ARCHITECTURE_x86_64
+#include "cpu_bench/jit_check.h"
+#endif
+#include "cpu_bench/memory_block_bench.h"
+#include "cpu_bench/vfp_host_check.h"
+#include "cpu_bench/wait_synchronization_bench.h"
+
+// Headless benchmark of the guest CPU cores. Small synthetic kernels are mapped into guest memory
+// and run through ARM_Interface::Run, and the guest MIPS and host time per guest instruction of
+// each kernel are written to stdout as CSV, so that results can be compared between builds. Other
+// modes benchmark the individual data structures of the cores, or check them against the slower
+// code they replaced.
+
+static const VAddr CODE_BASE = 0x00100000;
+static const u32 CODE_SIZE = 0x1000;
+static const VAddr DATA_BASE = 0x00200000;
+static const u32 DATA_SIZE = 0x4000;
+
+/// Source and destination buffers of the load/store kernels, the stack is at the top of the data region
+static const VAddr SRC_BUFFER = DATA_BASE;
+static const VAddr DST_BUFFER = DATA_BASE + 0x1000;
+static const VAddr STACK_TOP = DATA_BASE + DATA_SIZE;
+
+/// Number of instructions run per call to ARM_Interface::Run, the size of a typical timeslice
+static const int SLICE_INSTRUCTIONS = 100000;
+
+struct Kernel {
+    const char* name;
+    const char* description;
+    bool thumb;
+    /// Code of the kernel, an endless loop, as little-endian words
+    std::vector<u32> code;
+    /// Sets the initial register values
+    void (*setup)(ARM_Interface& cpu);
+};
+
+/// Packs Thumb instructions into words
+static std::vector<u32> ThumbCode(const std::vector<u16>& instructions) {
+    std::vector<u32> code((instructions.size() + 1) / 2);
+    std::memcpy(code.data(), instructions.data(), instructions.size() * sizeof(u16));
+    return code;
+}
+
+static void SetupALU(ARM_Interface& cpu) {
+    // Arbitrary non-zero seeds, so that the kernel does not only compute zeroes
+    cpu.SetReg(0, 0x12345678);
+    cpu.SetReg(1, 0x9ABCDEF1);
+    cpu.SetReg(2, 0x0F1E2D3C);
+    cpu.SetReg(4, 0x55AA55AA);
+}
+
+static void SetupARMLoadStore(ARM_Interface& cpu) {
+    cpu.SetReg(0, SRC_BUFFER);
+    cpu.SetReg(1, DST_BUFFER);
+    cpu.SetReg(2, 0x400);
+}
+
+static void SetupThumbLoadStore(ARM_Interface& cpu) {
+    cpu.SetReg(0, SRC_BUFFER);
+    cpu.SetReg(1, DST_BUFFER);
+    cpu.SetReg(2, 0x200);
+}
+
+static void SetupVFP(ARM_Interface& cpu) {
+    // Single precision: s1 = 1.0, s3 = 3.0, s7 = 0.5
+    cpu.SetVFPReg(1, 0x3F800000);
+    cpu.SetVFPReg(3, 0x40400000);
+    cpu.SetVFPReg(7, 0x3F000000);
+    // Double precision: d9 = 1.0, d11 = 3.0, d15 = 0.5
+    cpu.SetVFPReg(19, 0x3FF00000);
+    cpu.SetVFPReg(23, 0x40080000);
+    cpu.SetVFPReg(31, 0x3FE00000);
+}
+
+static std::vector<Kernel> GetKernels() {
+    return {
+        { "arm_alu", "ARM integer ALU loop with shifted operands and a multiply", false, {
+            0xE0800001, // add  r0, r0, r1
+            0xE02113E0, // eor  r1, r1, r0, ror #7
+            0xE1822180, // orr  r2, r2, r0, lsl #3
+            0xE20230FF, // and  r3, r2, #0xFF
+            0xE0444003, // sub  r4, r4, r3
+            0xE1A05124, // mov  r5, r4, lsr #2
+            0xE0060195, // mul  r6, r5, r1
+            0xE2577001, // subs r7, r7, #1
+            0x1AFFFFF6, // bne  0x00
+            0xE3E07000, // mvn  r7, #0
+            0xEAFFFFF4, // b    0x00
+        }, SetupALU },
+
+        { "thumb_alu", "Thumb integer ALU loop", true, ThumbCode({
+            0x1840, // adds r0, r0, r1
+            0x4041, // eors r1, r0
+            0x00C2, // lsls r2, r0, #3
+            0x430A, // orrs r2, r1
+            0x23FF, // movs r3, #0xFF
+            0x4013, // ands r3, r2
+            0x1AE4, // subs r4, r4, r3
+            0x08A5, // lsrs r5, r4, #2
+            0x436E, // muls r6, r5
+            0x3F01, // subs r7, #1
+            0xD1F4, // bne  0x00
+            0x27FF, // movs r7, #0xFF
+            0xE7F2, // b    0x00
+        }), SetupALU },
+
+        { "arm_loadstore", "ARM word, halfword and byte copy over a 4 KiB buffer", false, {
+            0xE4903004, // ldr  r3, [r0], #4
+            0xE5D04001, // ldrb r4, [r0, #1]
+            0xE0833004, // add  r3, r3, r4
+            0xE4813004, // str  r3, [r1], #4
+            0xE1D050B0, // ldrh r5, [r0]
+            0xE1C150B2, // strh r5, [r1, #2]
+            0xE2522001, // subs r2, r2, #1
+            0x1AFFFFF7, // bne  0x00
+            0xE2400A01, // sub  r0, r0, #0x1000
+            0xE2411A01, // sub  r1, r1, #0x1000
+            0xE3A02B01, // mov  r2, #0x400
+            0xEAFFFFF3, // b    0x00
+        }, SetupARMLoadStore },
+
+        { "thumb_loadstore", "Thumb multiple, halfword and byte copy over a 4 KiB buffer", true, ThumbCode({
+            0xC818, // ldmia r0!, {r3, r4}
+            0x7845, // ldrb  r5, [r0, #1]
+            0x195B, // adds  r3, r3, r5
+            0xC118, // stmia r1!, {r3, r4}
+            0x8846, // ldrh  r6, [r0, #2]
+            0x804E, // strh  r6, [r1, #2]
+            0x3A01, // subs  r2, #1
+            0xD1F7, // bne   0x00
+            0x2301, // movs  r3, #1
+            0x031B, // lsls  r3, r3, #12
+            0x1AC0, // subs  r0, r0, r3
+            0x1AC9, // subs  r1, r1, r3
+            0x2202, // movs  r2, #2
+            0x0212, // lsls  r2, r2, #8
+            0xE7F0, // b     0x00
+        }), SetupThumbLoadStore },
+
+        { "arm_branchy", "ARM data-dependent branches, conditional execution and calls", false, {
+            0xE0800100, // add   r0, r0, r0, lsl #2
+            0xE2800001, // add   r0, r0, #1
+            0xE3100010, // tst   r0, #0x10
+            0x0A000001, // beq   0x18
+            0xE2811001, // add   r1, r1, #1
+            0xEB000009, // bl    0x40
+            0xE3100C01, // tst   r0, #0x100
+            0x12822003, // addne r2, r2, #3
+            0x02422001, // subeq r2, r2, #1
+            0xE1500001, // cmp   r0, r1
+            0x3A000000, // blo   0x30
+            0xE0233000, // eor   r3, r3, r0
+            0xEAFFFFF2, // b     0x00
+            0xE1A00000, // nop
+            0xE1A00000, // nop
+            0xE1A00000, // nop
+            0xE92D4010, // push  {r4, lr}
+            0xE0814000, // add   r4, r1, r0
+            0xE0233004, // eor   r3, r3, r4
+            0xE8BD8010, // pop   {r4, pc}
+        }, nullptr },
+
+        { "vfp_single", "VFP single precision multiply, add, subtract and divide", false, {
+            0xEE200A23, // vmul.f32 s0, s0, s7
+            0xEE300A20, // vadd.f32 s0, s0, s1
+            0xEE201A21, // vmul.f32 s2, s0, s3
+            0xEE312A60, // vsub.f32 s4, s2, s1
+            0xEEC22A21, // vdiv.f32 s5, s4, s3
+            0xEE223AA3, // vmul.f32 s6, s5, s7
+            0xEAFFFFF8, // b        0x00
+        }, SetupVFP },
+
+        { "vfp_double", "VFP double precision multiply, add, subtract and divide", false, {
+            0xEE288B0F, // vmul.f64 d8, d8, d15
+            0xEE388B09, // vadd.f64 d8, d8, d9
+            0xEE28AB0B, // vmul.f64 d10, d8, d11
+            0xEE3ACB49, // vsub.f64 d12, d10, d9
+            0xEE8CDB0B, // vdiv.f64 d13, d12, d11
+            0xEE2DEB0F, // vmul.f64 d14, d13, d15
+            0xEAFFFFF8, // b        0x00
+        }, SetupVFP },
+    };
+}
+
+static std::unique_ptr<ARM_Interface> CreateCpu(const std::string& cpu_name) {
+    if (cpu_name == "dyncom")
+        return Common::make_unique<ARM_DynCom>(USER32MODE);
+#ifdef ARCHITECTURE_x86_64
+    if (cpu_name == "jit")
+        return Common::make_unique<ARM_JitX64>(USER32MODE);
+#endif
+    return nullptr;
+}
+
+struct Result {
+    u64 instructions;
+    double seconds;
+};
+
+/**
+ * Runs a kernel on a freshly created core.
+ * @param warmup_instructions Number of instructions run before timing starts, to translate the code
+ * @param num_instructions Minimum number of instructions to time
+ */
+static Result RunKernel(const Kernel& kernel, const std::string& cpu_name, u64 warmup_instructions,
+                        u64 num_instructions, std::vector<u8>& code_memory, std::vector<u8>& data_memory) {
+    std::fill(code_memory.begin(), code_memory.end(), 0);
+    std::memcpy(code_memory.data(), kernel.code.data(), kernel.code.size() * sizeof(u32));
+    for (size_t i = 0; i < data_memory.size(); ++i)
+        data_memory[i] = static_cast<u8>(i * 7);
+
+    Core::g_app_core = CreateCpu(cpu_name);
+    CoreTiming::Init();
+
+    ARM_Interface& cpu = *Core::g_app_core;
+    cpu.SetCPSR(USER32MODE | (kernel.thumb ? 0x20 : 0));
+    cpu.SetPC(CODE_BASE);
+    cpu.SetReg(13, STACK_TOP);
+    if (kernel.setup != nullptr)
+        kernel.setup(cpu);
+
+    const u64 warmup_start = CoreTiming::GetTicks();
+    while (CoreTiming::GetTicks() - warmup_start < warmup_instructions)
+        cpu.Run(SLICE_INSTRUCTIONS);
+
+    // Executed instructions are counted through the core timing, which is advanced by the number
+    // of instructions actually run rather than the number requested.
+    const u64 start_ticks = CoreTiming::GetTicks();
+    const auto start_time = std::chrono::steady_clock::now();
+    while (CoreTiming::GetTicks() - start_ticks < num_instructions)
+        cpu.Run(SLICE_INSTRUCTIONS);
+    const auto end_time = std::chrono::steady_clock::now();
+
+    Result result;
+    result.instructions = CoreTiming::GetTicks() - start_ticks;
+    result.seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+    CoreTiming::Shutdown();
+    Core::g_app_core = nullptr;
+    return result;
+}
+
+static void PrintHelp(const std::vector<Kernel>& kernels) {
+    std::cout << "Usage: cpu-bench [options] [kernel...]" << std::endl
+              << "  -m, --mode <mode>         What to run (default: kernels):" << std::endl
+              << "                              kernels: the guest kernels listed below" << std::endl
+              << "                              block-table: translated block lookups" << std::endl
+              << "                              arm-decoder: ARM decode table against a table scan" << std::endl
+              << "                              vfp-host: VFP ops on the host FPU against softfloat" << std::endl
+#ifdef ARCHITECTURE_x86_64
+              << "                              jit-check: random programs on the JIT against dyncom" << std::endl
+#endif
+              << "                              memory-block: block accesses of guest memory against bytes" << std::endl
+              << "                              core-timing: scheduling and firing of timed events" << std::endl
+              << "                              address-arbiter: signalling threads waiting on an address" << std::endl
+              << "                              wait-synch: the WaitSynchronizationN SVC on events" << std::endl
+              << "  -c, --cpu <name>          CPU core to benchmark: dyncom"
+#ifdef ARCHITECTURE_x86_64
+              << " or jit"
+#endif
+              << " (default: dyncom)" << std::endl
+              << "  -n, --instructions <n>    Guest instructions timed per run (default: 50000000)" << std::endl
+              << "  -r, --repeat <n>          Runs per benchmark, the fastest one is reported (default: 3)" << std::endl
+              << "  -h, --help                Show this help" << std::endl
+              << std::endl
+              << "Results are written to stdout as CSV. Kernels:" << std::endl;
+    for (const Kernel& kernel : kernels)
+        std::cout << "  " << kernel.name << ": " << kernel.description << std::endl;
+}
+
+/// Application entry point
+int main(int argc, char** argv) {
+    const std::vector<Kernel> kernels = GetKernels();
+
+    int option_index = 0;
+    std::string mode = "kernels";
+    std::string cpu_name = "dyncom";
+    u64 num_instructions = 50000000;
+    int num_repeats = 3;
+    std::vector<std::string> selected_kernels;
+    static struct option long_options[] = {
+        { "mode", required_argument, 0, 'm' },
+        { "cpu", required_argument, 0, 'c' },
+        { "instructions", required_argument, 0, 'n' },
+        { "repeat", required_argument, 0, 'r' },
+        { "help", no_argument, 0, 'h' },
+        { 0, 0, 0, 0 }
+    };
+
+    int arg;
+    while ((arg = getopt_long(argc, argv, "m:c:n:r:h", long_options, &option_index)) != -1) {
+        switch (arg) {
+        case 'm':
+            mode = optarg;
+            break;
+        case 'c':
+            cpu_name = optarg;
+            break;
+        case 'n':
+            num_instructions = std::strtoull(optarg, nullptr, 0);
+            break;
+        case 'r':
+            num_repeats = std::atoi(optarg);
+            break;
+        case 'h':
+            PrintHelp(kernels);
+            return 0;
+        default:
+            PrintHelp(kernels);
+            return -1;
+        }
+    }
+    // getopt moves the kernel names after the options
+    for (int i = optind; i < argc; ++i)
+        selected_kernels.push_back(argv[i]);
+
+    Log::Filter log_filter(Log::Level::Warning);
+    Log::SetFilter(&log_filter);
+
+    if (num_repeats <= 0) {
+        LOG_CRITICAL(Frontend, "The number of runs must be positive");
+        return -1;
+    }
+    if (mode == "block-table")
+        return RunBlockTableBenchmark(num_repeats);
+    if (mode == "arm-decoder")
+        return RunARMDecoderCheck(num_repeats);
+    if (mode == "vfp-host")
+        return RunVFPHostCheck(num_repeats);
+#ifdef ARCHITECTURE_x86_64
+    if (mode == "jit-check")
+        return RunJITCheck();
+#endif
+    if (mode == "memory-block")
+        return RunMemoryBlockBenchmark(num_repeats);
+    if (mode == "core-timing")
+        return RunCoreTimingBenchmark(num_repeats);
+    if (mode == "address-arbiter")
+        return RunAddressArbiterBenchmark(num_repeats);
+    if (mode == "wait-synch")
+        return RunWaitSynchronizationBenchmark(num_repeats);
+    if (mode != "kernels") {
+        LOG_CRITICAL(Frontend, "Unknown mode %s", mode.c_str());
+        return -1;
+    }
+
+    if (CreateCpu(cpu_name) == nullptr) {
+        LOG_CRITICAL(Frontend, "Unknown CPU core %s", cpu_name.c_str());
+        return -1;
+    }
+    if (num_instructions == 0) {
+        LOG_CRITICAL(Frontend, "The number of instructions must be positive");
+        return -1;
+    }
+    for (const std::string& name : selected_kernels) {
+        auto it = std::find_if(kernels.begin(), kernels.end(),
+                               [&name](const Kernel& kernel) { return name == kernel.name; });
+        if (it == kernels.end()) {
+            LOG_CRITICAL(Frontend, "Unknown kernel %s", name.c_str());
+            return -1;
+        }
+    }
+
+    std::vector<u8> code_memory(CODE_SIZE);
+    std::vector<u8> data_memory(DATA_SIZE);
+
+    // The page table is too large for the stack
+    auto page_table = Common::make_unique<Memory::PageTable>();
+    page_table->pointers.fill(nullptr);
+    page_table->attributes.fill(Memory::PageType::Unmapped);
+    page_table->cached_code.reset();
+
+    Memory::InitMemoryMap();
+    Memory::SetCurrentPageTable(page_table.get());
+    Memory::MapMemoryRegion(*page_table, CODE_BASE, CODE_SIZE, code_memory.data());
+    Memory::MapMemoryRegion(*page_table, DATA_BASE, DATA_SIZE, data_memory.data());
+
+    std::printf("kernel,cpu,instructions,seconds,mips,ns_per_instruction\n");
+
+    for (const Kernel& kernel : kernels) {
+        if (!selected_kernels.empty() &&
+            std::find(selected_kernels.begin(), selected_kernels.end(), kernel.name) == selected_kernels.end())
+            continue;
+
+        Result best = {};
+        for (int i = 0; i < num_repeats; ++i) {
+            const Result result = RunKernel(kernel, cpu_name, num_instructions / 10, num_instructions,
+                                            code_memory, data_memory);
+            if (i == 0 || result.seconds / result.instructions < best.seconds / best.instructions)
+                best = result;
+        }
+
+        std::printf("%s,%s,%llu,%.6f,%.2f,%.3f\n", kernel.name, cpu_name.c_str(),
+                    static_cast<unsigned long long>(best.instructions), best.seconds,
+                    best.instructions / best.seconds / 1e6, best.seconds * 1e9 / best.instructions);
+        std::fflush(stdout);
+    }
+
+    Memory::SetCurrentPageTable(nullptr);
+    return 0;
+}
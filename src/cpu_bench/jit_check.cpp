@@ -0,0 +1,234 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/make_unique.h"
+
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/memory.h"
+#include "core/memory_setup.h"
+#include "core/arm/arm_interface.h"
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/jit_x64/arm_jit_x64.h"
+#include "core/arm/skyeye_common/armstate.h"
+
+#include "cpu_bench/jit_check.h"
+
+// Each program is a straight run of random instructions ending in an infinite loop, which both
+// cores are left spinning in. Branches only jump forward, so every program reaches the loop.
+// Data processing instructions write r0-r10 and read any register, including the PC. Loads and
+// stores are based on r11, which starts in the middle of the data region, and their register
+// offsets come from r12, which is kept small. Neither is written by anything but base writeback,
+// so that all accesses stay within the data region.
+
+static const VAddr CODE_BASE = 0x00100000;
+static const u32 CODE_SIZE = 0x1000;
+static const VAddr DATA_BASE = 0x00200000;
+static const u32 DATA_SIZE = 0x10000;
+
+static const int NUM_PROGRAMS = 3000;
+static const u32 NUM_PROGRAM_INSTRUCTIONS = 48;
+/// Enough instructions for both cores to reach the final loop of any program
+static const int RUN_INSTRUCTIONS = 4 * NUM_PROGRAM_INSTRUCTIONS;
+
+static const u32 COND_AL = 0xE;
+static const u32 BRANCH_TO_SELF = 0xEAFFFFFE;
+
+struct CoreState {
+    std::array<u32, 16> regs;
+    u32 cpsr;
+    std::vector<u8> data;
+};
+
+/// One in four instructions is conditional
+static u32 RandomCondition(std::mt19937& rng) {
+    return rng() % 4 == 0 ? rng() % 14 : COND_AL;
+}
+
+/// Shift amount of an immediate shift, biased towards the amounts handled as special cases
+static u32 RandomShiftAmount(std::mt19937& rng) {
+    switch (rng() % 4) {
+    case 0:
+        return 0;
+    case 1:
+        return rng() % 2 ? 1 : 31;
+    default:
+        return rng() % 32;
+    }
+}
+
+static u32 RandomDataProcessing(std::mt19937& rng) {
+    const u32 op = rng() % 16;
+    // Comparisons without the S bit are miscellaneous instructions
+    const u32 s = op >= 8 && op <= 11 ? 1 : rng() % 2;
+    const u32 rn = rng() % 16;
+    const u32 rd = rng() % 11;
+
+    u32 operand;
+    if (rng() % 3 == 0) {
+        operand = 1 << 25 | (rng() % 16) << 8 | (rng() & 0xFF);
+    } else {
+        operand = RandomShiftAmount(rng) << 7 | (rng() % 4) << 5 | rng() % 16;
+    }
+    return RandomCondition(rng) << 28 | op << 21 | s << 20 | rn << 16 | rd << 12 | operand;
+}
+
+static u32 RandomLoadStore(std::mt19937& rng) {
+    const u32 p = rng() % 2;
+    const u32 u = rng() % 2;
+    const u32 b = rng() % 2;
+    // Post-indexed accesses with the W bit set are LDRT and the like
+    const u32 w = p ? rng() % 2 : 0;
+    const u32 l = rng() % 2;
+    const u32 rn = 11;
+    // Stores of the base register with writeback are unpredictable, as are byte stores of the PC
+    const bool writeback = !p || w;
+    u32 rd;
+    do {
+        rd = l ? rng() % 11 : rng() % 16;
+    } while ((writeback && rd == rn) || (b && rd == 15));
+
+    u32 offset;
+    if (rng() % 2) {
+        // LSL or LSR of r12
+        offset = 1 << 25 | (rng() % 4) << 7 | (rng() % 2) << 5 | 12;
+    } else {
+        offset = rng() & 0xFF;
+    }
+    return RandomCondition(rng) << 28 | 1 << 26 | p << 24 | u << 23 | b << 22 | w << 21 | l << 20 |
+           rn << 16 | rd << 12 | offset;
+}
+
+static std::vector<u32> RandomProgram(std::mt19937& rng) {
+    std::vector<u32> program;
+    for (u32 i = 0; i < NUM_PROGRAM_INSTRUCTIONS; ++i) {
+        const u32 kind = rng() % 16;
+        if (kind < 9) {
+            program.push_back(RandomDataProcessing(rng));
+        } else if (kind < 15) {
+            program.push_back(RandomLoadStore(rng));
+        } else {
+            // B or BL to any of the following instructions or the final loop. The offset is
+            // relative to the instruction after the next one.
+            const u32 target = i + 1 + rng() % (NUM_PROGRAM_INSTRUCTIONS - i);
+            const u32 link = rng() % 2;
+            program.push_back(RandomCondition(rng) << 28 | 0x0A000000 | link << 24 | ((target - i - 2) & 0xFFFFFF));
+        }
+    }
+    program.push_back(BRANCH_TO_SELF);
+    return program;
+}
+
+static CoreState RunProgram(std::unique_ptr<ARM_Interface> cpu, Memory::PageTable& page_table,
+                            const std::array<u32, 16>& regs, u32 cpsr, const std::vector<u8>& data,
+                            std::vector<u8>& data_memory) {
+    std::copy(data.begin(), data.end(), data_memory.begin());
+    page_table.cached_code.reset();
+
+    Core::g_app_core = std::move(cpu);
+    CoreTiming::Init();
+
+    ARM_Interface& core = *Core::g_app_core;
+    for (int i = 0; i < 15; ++i)
+        core.SetReg(i, regs[i]);
+    core.SetCPSR(cpsr);
+    core.SetPC(CODE_BASE);
+    core.Run(RUN_INSTRUCTIONS);
+
+    CoreState result;
+    for (int i = 0; i < 16; ++i)
+        result.regs[i] = core.GetReg(i);
+    result.cpsr = core.GetCPSR();
+    result.data = data_memory;
+
+    CoreTiming::Shutdown();
+    Core::g_app_core = nullptr;
+    return result;
+}
+
+/// Logs the first difference between the states the JIT and the interpreter ended up with
+static void LogMismatch(int program, const CoreState& jit, const CoreState& interpreter) {
+    for (int i = 0; i < 16; ++i) {
+        if (jit.regs[i] != interpreter.regs[i]) {
+            LOG_ERROR(Frontend, "Program %d: r%d is %08X on the JIT instead of %08X", program, i,
+                      jit.regs[i], interpreter.regs[i]);
+            return;
+        }
+    }
+    if (jit.cpsr != interpreter.cpsr) {
+        LOG_ERROR(Frontend, "Program %d: CPSR is %08X on the JIT instead of %08X", program, jit.cpsr,
+                  interpreter.cpsr);
+        return;
+    }
+    const auto diff = std::mismatch(jit.data.begin(), jit.data.end(), interpreter.data.begin());
+    LOG_ERROR(Frontend, "Program %d: byte at 0x%08X is %02X on the JIT instead of %02X", program,
+              static_cast<u32>(DATA_BASE + (diff.first - jit.data.begin())), *diff.first, *diff.second);
+}
+
+int RunJITCheck() {
+    std::vector<u8> code_memory(CODE_SIZE);
+    std::vector<u8> data_memory(DATA_SIZE);
+
+    // The page table is too large for the stack
+    auto page_table = Common::make_unique<Memory::PageTable>();
+    page_table->pointers.fill(nullptr);
+    page_table->attributes.fill(Memory::PageType::Unmapped);
+    page_table->cached_code.reset();
+
+    Memory::InitMemoryMap();
+    Memory::SetCurrentPageTable(page_table.get());
+    Memory::MapMemoryRegion(*page_table, CODE_BASE, CODE_SIZE, code_memory.data());
+    Memory::MapMemoryRegion(*page_table, DATA_BASE, DATA_SIZE, data_memory.data());
+
+    std::mt19937 rng(1);
+    std::vector<u8> data(DATA_SIZE);
+    int num_mismatches = 0;
+    for (int program = 0; program < NUM_PROGRAMS; ++program) {
+        const std::vector<u32> code = RandomProgram(rng);
+        std::memcpy(code_memory.data(), code.data(), code.size() * sizeof(u32));
+
+        std::array<u32, 16> regs;
+        for (u32& reg : regs)
+            reg = rng();
+        regs[11] = DATA_BASE + DATA_SIZE / 2;
+        regs[12] = rng() % 0x40;
+        // Loads in big endian mode take the slow path of the JIT's inline page table lookup
+        const u32 cpsr = USER32MODE | (rng() & 0xF0000000) | (rng() % 4 == 0 ? 1 << 9 : 0);
+        for (u8& byte : data)
+            byte = static_cast<u8>(rng());
+
+        const CoreState jit = RunProgram(Common::make_unique<ARM_JitX64>(USER32MODE), *page_table, regs,
+                                         cpsr, data, data_memory);
+        const CoreState interpreter = RunProgram(Common::make_unique<ARM_DynCom>(USER32MODE), *page_table,
+                                                 regs, cpsr, data, data_memory);
+        if (jit.regs == interpreter.regs && jit.cpsr == interpreter.cpsr && jit.data == interpreter.data)
+            continue;
+
+        // Only the first few are logged, a broken instruction usually breaks many programs
+        if (num_mismatches++ < 16)
+            LogMismatch(program, jit, interpreter);
+    }
+
+    Memory::SetCurrentPageTable(nullptr);
+
+    std::printf("programs,instructions_per_program,mismatching_programs\n");
+    std::printf("%d,%u,%d\n", NUM_PROGRAMS, NUM_PROGRAM_INSTRUCTIONS, num_mismatches);
+    std::fflush(stdout);
+
+    if (num_mismatches != 0) {
+        LOG_CRITICAL(Frontend, "%d programs gave different results on the JIT", num_mismatches);
+        return -1;
+    }
+    return 0;
+}
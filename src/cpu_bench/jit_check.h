@@ -0,0 +1,14 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+/**
+ * Checks that the x86_64 JIT gives the same results as the dyncom interpreter, by running random
+ * ARM programs of data processing instructions, loads, stores and forward branches on both cores
+ * and comparing the registers, CPSR and data memory they end up with. A summary is written to
+ * stdout as CSV.
+ * @return 0 on success, non-zero if the cores disagreed on a program
+ */
+int RunJITCheck();
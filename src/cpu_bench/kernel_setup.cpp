@@ -0,0 +1,46 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <vector>
+
+#include "core/core_timing.h"
+#include "core/memory.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/memory.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/thread.h"
+
+#include "cpu_bench/kernel_setup.h"
+
+/// Size of the memory of the benchmark process, which holds the entry point and the data page
+static const u32 PROCESS_MEMORY_SIZE = 2 * Memory::PAGE_SIZE;
+
+Kernel::SharedPtr<Kernel::Thread> InitBenchKernel(s32 main_thread_priority) {
+    CoreTiming::Init();
+    Memory::Init();
+    Kernel::Init();
+
+    // This only sets up what Process::Run does for the threads, which leaves out the translation
+    // disk cache
+    auto codeset = Kernel::CodeSet::Create("cpu-bench", 0);
+    Kernel::g_current_process = Kernel::Process::Create(std::move(codeset));
+    Kernel::g_current_process->memory_region = Kernel::GetMemoryRegion(Kernel::MemoryRegion::APPLICATION);
+    Kernel::g_current_process->vm_manager.MapMemoryBlock(Memory::PROCESS_IMAGE_VADDR,
+            std::make_shared<std::vector<u8>>(PROCESS_MEMORY_SIZE, 0), 0, PROCESS_MEMORY_SIZE,
+            Kernel::MemoryState::Private).Unwrap();
+    Memory::SetCurrentPageTable(&Kernel::g_current_process->vm_manager.page_table);
+
+    return Kernel::SetupMainThread(Memory::PROCESS_IMAGE_VADDR, main_thread_priority);
+}
+
+void ShutdownBenchKernel() {
+    Kernel::Shutdown();
+    CoreTiming::Shutdown();
+}
+
+Kernel::SharedPtr<Kernel::Thread> CreateBenchThread(s32 priority) {
+    return Kernel::Thread::Create("bench", Memory::PROCESS_IMAGE_VADDR, priority, 0,
+                                  THREADPROCESSORID_0, Memory::HEAP_VADDR_END).MoveFrom();
+}
@@ -0,0 +1,35 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+#include "core/memory.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/thread.h"
+
+// Setup of the HLE kernel for the benchmarks that call into it directly instead of running guest
+// code: one process, whose threads are switched between by the benchmarks themselves.
+
+/// Guest address of a page of zeroed, writable memory of the benchmark process
+const VAddr BENCH_DATA_VADDR = Memory::PROCESS_IMAGE_VADDR + Memory::PAGE_SIZE;
+
+/**
+ * Initializes the kernel with a process, whose main thread is made current. The application core
+ * must have been created.
+ * @param main_thread_priority Priority of the main thread
+ * @return The main thread
+ */
+Kernel::SharedPtr<Kernel::Thread> InitBenchKernel(s32 main_thread_priority);
+
+/// Shuts down the kernel initialized by InitBenchKernel, along with its threads
+void ShutdownBenchKernel();
+
+/**
+ * Creates a thread of the benchmark process, which is left ready to run
+ * @param priority Priority of the thread
+ * @return The new thread
+ */
+Kernel::SharedPtr<Kernel::Thread> CreateBenchThread(s32 priority);
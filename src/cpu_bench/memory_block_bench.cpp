@@ -0,0 +1,198 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/make_unique.h"
+
+#include "core/memory.h"
+#include "core/memory_setup.h"
+
+#include "cpu_bench/memory_block_bench.h"
+
+// Both the source and the destination regions are made of two host allocations mapped back to back,
+// so that the blocks cross from one allocation into the other like HLE buffers do when they straddle
+// two mapped regions. They are mapped in the linear heap, where writes are also tracked for the GPU.
+
+static const VAddr SRC_REGION = Memory::LINEAR_HEAP_VADDR;
+static const VAddr DST_REGION = Memory::LINEAR_HEAP_VADDR + 0x00200000;
+/// Size of each of the two host allocations backing a region
+static const u32 HALF_REGION_SIZE = 480 * 1024;
+static const u32 REGION_SIZE = 2 * HALF_REGION_SIZE;
+
+static const int NUM_CHECKED_BLOCKS = 2000;
+
+enum class Access { Read, Write, Copy, Zero };
+
+static const char* ACCESS_NAMES[] = { "read", "write", "copy", "zero" };
+
+struct Regions {
+    std::vector<u8> src_low, src_high;
+    std::vector<u8> dst_low, dst_high;
+    /// Host side buffer of reads and writes
+    std::vector<u8> host;
+};
+
+/// Accesses a block through the block functions
+static void AccessByBlock(Access access, u32 offset, u32 size, Regions& regions) {
+    switch (access) {
+    case Access::Read:
+        Memory::ReadBlock(SRC_REGION + offset, regions.host.data() + offset, size);
+        break;
+    case Access::Write:
+        Memory::WriteBlock(DST_REGION + offset, regions.host.data() + offset, size);
+        break;
+    case Access::Copy:
+        Memory::CopyBlock(DST_REGION + offset, SRC_REGION + offset, size);
+        break;
+    case Access::Zero:
+        Memory::ZeroBlock(DST_REGION + offset, size);
+        break;
+    }
+}
+
+/// Accesses a block one byte at a time, the way the HLE code did before the block functions
+static void AccessByByte(Access access, u32 offset, u32 size, Regions& regions) {
+    switch (access) {
+    case Access::Read:
+        for (u32 i = offset; i < offset + size; ++i)
+            regions.host[i] = Memory::Read8(SRC_REGION + i);
+        break;
+    case Access::Write:
+        for (u32 i = offset; i < offset + size; ++i)
+            Memory::Write8(DST_REGION + i, regions.host[i]);
+        break;
+    case Access::Copy:
+        for (u32 i = offset; i < offset + size; ++i)
+            Memory::Write8(DST_REGION + i, Memory::Read8(SRC_REGION + i));
+        break;
+    case Access::Zero:
+        for (u32 i = offset; i < offset + size; ++i)
+            Memory::Write8(DST_REGION + i, 0);
+        break;
+    }
+}
+
+/// Fills every buffer with a pattern that differs between them
+static void ResetRegions(Regions& regions) {
+    for (u32 i = 0; i < HALF_REGION_SIZE; ++i) {
+        regions.src_low[i] = static_cast<u8>(i * 7 + 1);
+        regions.src_high[i] = static_cast<u8>(i * 11 + 2);
+        regions.dst_low[i] = static_cast<u8>(i * 13 + 3);
+        regions.dst_high[i] = static_cast<u8>(i * 17 + 4);
+    }
+    for (u32 i = 0; i < REGION_SIZE; ++i)
+        regions.host[i] = static_cast<u8>(i * 19 + 5);
+}
+
+/// Maps the guest side buffers of the given copy of the memory
+static void MapRegions(Memory::PageTable& page_table, Regions& regions) {
+    Memory::MapMemoryRegion(page_table, SRC_REGION, HALF_REGION_SIZE, regions.src_low.data());
+    Memory::MapMemoryRegion(page_table, SRC_REGION + HALF_REGION_SIZE, HALF_REGION_SIZE, regions.src_high.data());
+    Memory::MapMemoryRegion(page_table, DST_REGION, HALF_REGION_SIZE, regions.dst_low.data());
+    Memory::MapMemoryRegion(page_table, DST_REGION + HALF_REGION_SIZE, HALF_REGION_SIZE, regions.dst_high.data());
+}
+
+static bool SameContents(const Regions& a, const Regions& b) {
+    return a.dst_low == b.dst_low && a.dst_high == b.dst_high && a.host == b.host;
+}
+
+/**
+ * Runs the same random blocks through both paths, each on its own copy of the memory, and compares
+ * the results.
+ */
+static bool CheckAccesses(Memory::PageTable& page_table, Regions& block_regions, Regions& byte_regions) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<u32> access_dist(0, 3);
+    // Most blocks are a few pages long, the rest are much longer
+    std::uniform_int_distribution<u32> short_size_dist(1, 4 * Memory::PAGE_SIZE);
+    std::uniform_int_distribution<u32> long_size_dist(1, REGION_SIZE);
+
+    for (int i = 0; i < NUM_CHECKED_BLOCKS; ++i) {
+        const Access access = static_cast<Access>(access_dist(rng));
+        const u32 size = (i % 8 == 0) ? long_size_dist(rng) : short_size_dist(rng);
+        const u32 offset = std::uniform_int_distribution<u32>(0, REGION_SIZE - size)(rng);
+
+        ResetRegions(block_regions);
+        ResetRegions(byte_regions);
+
+        MapRegions(page_table, block_regions);
+        AccessByBlock(access, offset, size, block_regions);
+
+        MapRegions(page_table, byte_regions);
+        AccessByByte(access, offset, size, byte_regions);
+
+        if (!SameContents(block_regions, byte_regions)) {
+            LOG_CRITICAL(Frontend, "%s of 0x%X bytes at offset 0x%X differs from the byte-wise result",
+                         ACCESS_NAMES[static_cast<int>(access)], size, offset);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename AccessFunc>
+static double TimeAccess(Access access, Regions& regions, AccessFunc func, int num_repeats) {
+    double best = 0.0;
+    for (int i = 0; i < num_repeats; ++i) {
+        const auto start_time = std::chrono::steady_clock::now();
+        func(access, 0, REGION_SIZE, regions);
+        const auto end_time = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+        if (i == 0 || seconds < best)
+            best = seconds;
+    }
+    return best;
+}
+
+static void PrintResult(Access access, const char* path, double seconds) {
+    std::printf("%s,%s,%u,%.1f,%.3f\n", ACCESS_NAMES[static_cast<int>(access)], path, REGION_SIZE,
+                seconds * 1e6, seconds * 1e9 / REGION_SIZE);
+    std::fflush(stdout);
+}
+
+int RunMemoryBlockBenchmark(int num_repeats) {
+    Regions block_regions, byte_regions;
+    for (Regions* regions : { &block_regions, &byte_regions }) {
+        regions->src_low.resize(HALF_REGION_SIZE);
+        regions->src_high.resize(HALF_REGION_SIZE);
+        regions->dst_low.resize(HALF_REGION_SIZE);
+        regions->dst_high.resize(HALF_REGION_SIZE);
+        regions->host.resize(REGION_SIZE);
+    }
+
+    // The page table is too large for the stack
+    auto page_table = Common::make_unique<Memory::PageTable>();
+    page_table->pointers.fill(nullptr);
+    page_table->attributes.fill(Memory::PageType::Unmapped);
+    page_table->cached_code.reset();
+
+    Memory::InitMemoryMap();
+    Memory::SetCurrentPageTable(page_table.get());
+
+    int result = 0;
+    if (CheckAccesses(*page_table, block_regions, byte_regions)) {
+        std::printf("access,path,bytes,us_per_block,ns_per_byte\n");
+
+        ResetRegions(block_regions);
+        MapRegions(*page_table, block_regions);
+
+        for (Access access : { Access::Read, Access::Write, Access::Copy, Access::Zero }) {
+            PrintResult(access, "byte", TimeAccess(access, block_regions, AccessByByte, num_repeats));
+            PrintResult(access, "block", TimeAccess(access, block_regions, AccessByBlock, num_repeats));
+        }
+    } else {
+        result = -1;
+    }
+
+    Memory::SetCurrentPageTable(nullptr);
+    return result;
+}
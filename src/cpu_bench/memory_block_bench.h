@@ -0,0 +1,14 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+/**
+ * Checks that the page-chunked block accesses of guest memory give the same results as going through
+ * the memory one byte at a time, over random blocks crossing pages and host allocations, and compares
+ * the speed of both. The timings are written to stdout as CSV.
+ * @param num_repeats Number of runs per access and path, the fastest one is reported
+ * @return 0 on success, non-zero if the two paths disagreed on a block
+ */
+int RunMemoryBlockBenchmark(int num_repeats);
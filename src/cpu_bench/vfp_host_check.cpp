@@ -0,0 +1,234 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+
+#include "core/arm/skyeye_common/armstate.h"
+#include "core/arm/skyeye_common/vfp/asm_vfp.h"
+#include "core/arm/skyeye_common/vfp/vfp.h"
+#include "core/arm/skyeye_common/vfp/vfp_host.h"
+
+#include "cpu_bench/vfp_host_check.h"
+
+// Every instruction is run twice by vfp_single_cpdo or vfp_double_cpdo, once with the FPSCR under
+// test and once with the input denormal trap enabled on top of it. The host path declines to run
+// whenever a trap is enabled, while the softfloat code never looks at the trap enables: they only
+// matter to the callers, which raise the traps from the returned flags. The second run thus gives
+// the result of the softfloat code for the same configuration.
+
+static const u32 SOFTFLOAT_ONLY = FPSCR_IDE;
+
+static const int NUM_CHECKED_INSTRUCTIONS = 1 << 21;
+static const int NUM_TIMED_INSTRUCTIONS = 1 << 20;
+static const u32 NUM_OPS = 9;
+
+static const u32 FPSCR_CONFIGS[] = {
+    FPSCR_ROUND_NEAREST,
+    FPSCR_ROUND_NEAREST | FPSCR_FLUSH_TO_ZERO,
+    FPSCR_ROUND_NEAREST | FPSCR_DEFAULT_NAN,
+    FPSCR_ROUND_NEAREST | FPSCR_FLUSH_TO_ZERO | FPSCR_DEFAULT_NAN,
+    FPSCR_ROUND_PLUSINF,
+    FPSCR_ROUND_MINUSINF,
+    FPSCR_ROUND_TOZERO,
+};
+
+/// Names of the ops, indexed like VFPHost::OP_FMAC and the other op indices
+static const char* OP_NAMES[NUM_OPS] = {
+    "fmac", "fmsc", "fmul", "fadd", "fnmac", "fnmsc", "fnmul", "fsub", "fdiv",
+};
+
+/**
+ * Encodes the data-processing instruction with the given op index computing s0 = s2 op s4 in single
+ * precision, or d0 = d1 op d2 in double precision.
+ */
+static u32 EncodeInstruction(u32 op, bool double_precision) {
+    return 0x0E000A00 | (double_precision ? 0x100 : 0) | ((op & 0xB) << 20) | ((op & 4) << 4) |
+           (1 << 16) | 2;
+}
+
+/// Random single precision operand, biased towards the special cases of both paths
+static u32 RandomSingle(std::mt19937_64& rng) {
+    const u32 sign = rng() & 0x80000000;
+    const u32 significand = rng() & 0x7FFFFF;
+    switch (rng() % 10) {
+    case 0:
+        return sign;
+    case 1:
+        // Denormal
+        return sign | significand;
+    case 2:
+        // Infinity or NaN
+        return sign | 0x7F800000 | ((rng() & 1) ? significand : 0);
+    case 3:
+        // Small integer, which makes exact results likely
+        return VFPHost::ToBits(static_cast<float>(static_cast<int>(rng() % 200) - 100));
+    case 4:
+        // Close to underflowing
+        return sign | static_cast<u32>(rng() % 40 + 1) << 23 | significand;
+    case 5:
+        // Close to overflowing
+        return sign | static_cast<u32>(254 - rng() % 20) << 23 | significand;
+    default:
+        return sign | static_cast<u32>(117 + rng() % 20) << 23 | significand;
+    }
+}
+
+/// Random double precision operand, biased towards the special cases of both paths
+static u64 RandomDouble(std::mt19937_64& rng) {
+    const u64 sign = rng() & (1ull << 63);
+    const u64 significand = rng() & 0xFFFFFFFFFFFFFull;
+    switch (rng() % 10) {
+    case 0:
+        return sign;
+    case 1:
+        return sign | significand;
+    case 2:
+        return sign | 0x7FF0000000000000ull | ((rng() & 1) ? significand : 0);
+    case 3:
+        return VFPHost::ToBits(static_cast<double>(static_cast<int>(rng() % 200) - 100));
+    case 4:
+        return sign | static_cast<u64>(rng() % 200 + 1) << 52 | significand;
+    case 5:
+        return sign | static_cast<u64>(2046 - rng() % 200) << 52 | significand;
+    default:
+        return sign | static_cast<u64>(1013 + rng() % 20) << 52 | significand;
+    }
+}
+
+static void PutDouble(ARMul_State& state, int reg, u64 value) {
+    state.ExtReg[reg * 2] = static_cast<u32>(value);
+    state.ExtReg[reg * 2 + 1] = static_cast<u32>(value >> 32);
+}
+
+static u64 GetDouble(const ARMul_State& state, int reg) {
+    return static_cast<u64>(state.ExtReg[reg * 2 + 1]) << 32 | state.ExtReg[reg * 2];
+}
+
+static u32 Execute(ARMul_State& state, u32 inst, u32 fpscr) {
+    if (inst & 0x100)
+        return vfp_double_cpdo(&state, inst, fpscr);
+    return vfp_single_cpdo(&state, inst, fpscr);
+}
+
+static int CheckResults() {
+    std::mt19937_64 rng(1);
+    ARMul_State host(USER32MODE);
+    ARMul_State softfloat(USER32MODE);
+
+    int num_mismatches = 0;
+    for (int i = 0; i < NUM_CHECKED_INSTRUCTIONS; ++i) {
+        const bool double_precision = (rng() & 1) != 0;
+        const u32 op = rng() % NUM_OPS;
+        const u32 inst = EncodeInstruction(op, double_precision);
+        const u32 fpscr = FPSCR_CONFIGS[rng() % (sizeof(FPSCR_CONFIGS) / sizeof(u32))];
+        const bool cancel = rng() % 4 == 0;
+
+        // The destination is an input of the multiply-accumulate ops. One in four instructions has
+        // operands of nearly equal magnitude and opposite signs, to exercise cancellation.
+        if (double_precision) {
+            for (int reg = 0; reg < 3; ++reg)
+                PutDouble(host, reg, RandomDouble(rng));
+            if (cancel)
+                PutDouble(host, 2, (GetDouble(host, 1) ^ (1ull << 63)) ^ (rng() % 4));
+        } else {
+            for (int reg = 0; reg < 3; ++reg)
+                host.ExtReg[reg * 2] = RandomSingle(rng);
+            if (cancel)
+                host.ExtReg[4] = (host.ExtReg[2] ^ 0x80000000) ^ (rng() % 4);
+        }
+        softfloat.ExtReg = host.ExtReg;
+
+        const u32 inputs[3] = { host.ExtReg[0], host.ExtReg[2], host.ExtReg[4] };
+        const unsigned long long double_inputs[3] = { GetDouble(host, 0), GetDouble(host, 1), GetDouble(host, 2) };
+
+        const u32 host_exceptions = Execute(host, inst, fpscr);
+        const u32 softfloat_exceptions = Execute(softfloat, inst, fpscr | SOFTFLOAT_ONLY);
+        if (host_exceptions == softfloat_exceptions && host.ExtReg == softfloat.ExtReg)
+            continue;
+
+        // Only the first few are logged, a broken fast path usually gets many operands wrong
+        if (num_mismatches++ >= 16)
+            continue;
+        if (double_precision) {
+            LOG_ERROR(Frontend, "%sd with FPSCR %08X, d0=%016llX d1=%016llX d2=%016llX: "
+                      "host gives %016llX, flags %08X, softfloat gives %016llX, flags %08X",
+                      OP_NAMES[op], fpscr, double_inputs[0], double_inputs[1],
+                      double_inputs[2], static_cast<unsigned long long>(GetDouble(host, 0)),
+                      host_exceptions, static_cast<unsigned long long>(GetDouble(softfloat, 0)),
+                      softfloat_exceptions);
+        } else {
+            LOG_ERROR(Frontend, "%ss with FPSCR %08X, s0=%08X s2=%08X s4=%08X: "
+                      "host gives %08X, flags %08X, softfloat gives %08X, flags %08X",
+                      OP_NAMES[op], fpscr, inputs[0], inputs[1], inputs[2],
+                      host.ExtReg[0], host_exceptions, softfloat.ExtReg[0], softfloat_exceptions);
+        }
+    }
+    return num_mismatches;
+}
+
+/// Runs an instruction over typical operands, which are normal numbers of moderate magnitude
+static double TimeInstruction(u32 inst, u32 fpscr, int num_repeats) {
+    std::mt19937 rng(1);
+    ARMul_State state(USER32MODE);
+    const bool double_precision = (inst & 0x100) != 0;
+
+    u64 operands[64];
+    for (u64& operand : operands) {
+        const double value = (rng() % 10000) / 77.0 + 1;
+        operand = double_precision ? VFPHost::ToBits(value) : VFPHost::ToBits(static_cast<float>(value));
+    }
+
+    double best = 0.0;
+    for (int repeat = 0; repeat < num_repeats; ++repeat) {
+        const auto start_time = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_TIMED_INSTRUCTIONS; ++i) {
+            for (int reg = 0; reg < 3; ++reg) {
+                const u64 operand = operands[(i + reg * 7) & 63];
+                if (double_precision)
+                    PutDouble(state, reg, operand);
+                else
+                    state.ExtReg[reg * 2] = static_cast<u32>(operand);
+            }
+            Execute(state, inst, fpscr);
+        }
+        const auto end_time = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+        if (repeat == 0 || seconds < best)
+            best = seconds;
+    }
+    return best;
+}
+
+int RunVFPHostCheck(int num_repeats) {
+    if (VFPHost::IsUsable(FPSCR_ROUND_NEAREST | SOFTFLOAT_ONLY)) {
+        LOG_CRITICAL(Frontend, "The host FPU path can't be disabled through the FPSCR any more");
+        return -1;
+    }
+
+    std::printf("instruction,instructions,host_ns_per_instruction,softfloat_ns_per_instruction\n");
+    for (int double_precision = 0; double_precision < 2; ++double_precision) {
+        for (u32 op : { VFPHost::OP_FADD, VFPHost::OP_FMUL, VFPHost::OP_FDIV, VFPHost::OP_FMAC }) {
+            const u32 inst = EncodeInstruction(op, double_precision != 0);
+            const double host = TimeInstruction(inst, FPSCR_ROUND_NEAREST, num_repeats);
+            const double softfloat = TimeInstruction(inst, FPSCR_ROUND_NEAREST | SOFTFLOAT_ONLY, num_repeats);
+            std::printf("%s%c,%d,%.3f,%.3f\n", OP_NAMES[op], double_precision ? 'd' : 's',
+                        NUM_TIMED_INSTRUCTIONS, host * 1e9 / NUM_TIMED_INSTRUCTIONS,
+                        softfloat * 1e9 / NUM_TIMED_INSTRUCTIONS);
+            std::fflush(stdout);
+        }
+    }
+
+    const int num_mismatches = CheckResults();
+    if (num_mismatches != 0) {
+        LOG_CRITICAL(Frontend, "%d instructions gave different results on the host FPU", num_mismatches);
+        return -1;
+    }
+    return 0;
+}
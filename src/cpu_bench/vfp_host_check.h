@@ -0,0 +1,14 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+/**
+ * Checks that running VFP data-processing instructions on the host FPU gives the same results and
+ * cumulative exception flags as the softfloat code, over random operands and FPSCR configurations,
+ * and compares the speed of both. The timings are written to stdout as CSV.
+ * @param num_repeats Number of runs per op and path, the fastest one is reported
+ * @return 0 on success, non-zero if the two paths disagreed on an instruction
+ */
+int RunVFPHostCheck(int num_repeats);
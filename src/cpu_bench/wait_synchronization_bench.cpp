@@ -0,0 +1,137 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/make_unique.h"
+
+#include "core/core.h"
+#include "core/memory.h"
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/arm/skyeye_common/armstate.h"
+#include "core/hle/result.h"
+#include "core/hle/svc.h"
+#include "core/hle/kernel/event.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/thread.h"
+
+#include "cpu_bench/kernel_setup.h"
+#include "cpu_bench/wait_synchronization_bench.h"
+
+// The SVC is called through CallSVC with its arguments in the registers, as the CPU core does, and
+// the handle array in guest memory. In the "ready-any" and "ready-all" workloads, all the events are
+// sticky and signaled, so the call returns right away, either selecting the first event or
+// acquiring all of them. In the "wait-wake" workload, the events are one-shot and none is signaled,
+// so the thread waits on all of them. The last event is then signaled, and once the thread is
+// switched back to, the SVC is called again and acquires it, like a thread waking up does.
+
+static const int NUM_HANDLES[] = { 1, 16, 64, 256 };
+static const u32 SVC_WAIT_SYNCHRONIZATION_N = 0x25;
+/// Number of calls per run of the workloads where the events are ready
+static const u64 NUM_READY_CALLS = 200000;
+/// Number of waits and wakeups per run of the "wait-wake" workload
+static const u64 NUM_WAKEUPS = 100000;
+
+enum class Workload { ReadyAny, ReadyAll, WaitWake };
+
+static std::vector<Kernel::SharedPtr<Kernel::Event>> events;
+
+/// Calls WaitSynchronizationN on the handles written at BENCH_DATA_VADDR, without a timeout
+static void CallWaitSynchronizationN(int num_handles, bool wait_all) {
+    Core::g_app_core->SetReg(0, 0xFFFFFFFF);
+    Core::g_app_core->SetReg(1, BENCH_DATA_VADDR);
+    Core::g_app_core->SetReg(2, num_handles);
+    Core::g_app_core->SetReg(3, wait_all);
+    Core::g_app_core->SetReg(4, 0xFFFFFFFF);
+    SVC::CallSVC(SVC_WAIT_SYNCHRONIZATION_N);
+}
+
+static bool CallSucceeded() {
+    return Core::g_app_core->GetReg(0) == RESULT_SUCCESS.raw;
+}
+
+/**
+ * Runs a workload on num_handles events
+ * @param seconds Set to the time taken
+ * @return Whether all the calls returned the expected result
+ */
+static bool RunWorkload(Workload workload, int num_handles, double* seconds) {
+    Kernel::SharedPtr<Kernel::Thread> main_thread = InitBenchKernel(0x30);
+
+    const bool ready = workload != Workload::WaitWake;
+    for (int i = 0; i < num_handles; ++i) {
+        auto event = Kernel::Event::Create(ready ? RESETTYPE_STICKY : RESETTYPE_ONESHOT);
+        if (ready)
+            event->Signal();
+        Memory::Write32(BENCH_DATA_VADDR + i * sizeof(Handle), Kernel::g_handle_table.Create(event).MoveFrom());
+        events.push_back(std::move(event));
+    }
+
+    bool succeeded = true;
+    const auto start_time = std::chrono::steady_clock::now();
+    if (ready) {
+        const bool wait_all = workload == Workload::ReadyAll;
+        for (u64 i = 0; i < NUM_READY_CALLS; ++i)
+            CallWaitSynchronizationN(num_handles, wait_all);
+        succeeded = CallSucceeded();
+    } else {
+        for (u64 i = 0; i < NUM_WAKEUPS; ++i) {
+            CallWaitSynchronizationN(num_handles, false);
+            Kernel::Reschedule();
+            succeeded &= Kernel::GetCurrentThread() == nullptr;
+
+            events.back()->Signal();
+            Kernel::Reschedule();
+            CallWaitSynchronizationN(num_handles, false);
+            succeeded &= CallSucceeded();
+        }
+    }
+    const auto end_time = std::chrono::steady_clock::now();
+    *seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+    events.clear();
+    main_thread = nullptr;
+    ShutdownBenchKernel();
+    return succeeded;
+}
+
+static bool RunBest(const char* name, Workload workload, int num_handles, u64 num_operations, int num_repeats) {
+    double best = 0.0;
+    for (int i = 0; i < num_repeats; ++i) {
+        double seconds;
+        if (!RunWorkload(workload, num_handles, &seconds)) {
+            LOG_CRITICAL(Frontend, "WaitSynchronizationN failed in the %s workload with %d handles", name,
+                         num_handles);
+            return false;
+        }
+        if (i == 0 || seconds < best)
+            best = seconds;
+    }
+
+    std::printf("%s,%d,%llu,%.6f,%.3f\n", name, num_handles, static_cast<unsigned long long>(num_operations),
+                best, best * 1e9 / num_operations);
+    std::fflush(stdout);
+    return true;
+}
+
+int RunWaitSynchronizationBenchmark(int num_repeats) {
+    // The SVC arguments and results are passed in the registers of the application core
+    Core::g_app_core = Common::make_unique<ARM_DynCom>(USER32MODE);
+
+    bool succeeded = true;
+    std::printf("workload,handles,operations,seconds,ns_per_operation\n");
+    for (int num_handles : NUM_HANDLES)
+        succeeded &= RunBest("ready-any", Workload::ReadyAny, num_handles, NUM_READY_CALLS, num_repeats);
+    for (int num_handles : NUM_HANDLES)
+        succeeded &= RunBest("ready-all", Workload::ReadyAll, num_handles, NUM_READY_CALLS, num_repeats);
+    for (int num_handles : NUM_HANDLES)
+        succeeded &= RunBest("wait-wake", Workload::WaitWake, num_handles, NUM_WAKEUPS, num_repeats);
+
+    Core::g_app_core = nullptr;
+    return succeeded ? 0 : 1;
+}
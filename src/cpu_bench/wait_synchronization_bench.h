@@ -0,0 +1,14 @@
+// Copyright 2015 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+/**
+ * Times the WaitSynchronizationN SVC on 1 to 256 event handles, both on events that are already
+ * signaled and on events that the calling thread has to wait on until one of them is signaled.
+ * The results are written to stdout as CSV.
+ * @param num_repeats Number of runs per workload, the fastest one is reported
+ * @return 0 on success, non-zero if a call didn't return the expected result
+ */
+int RunWaitSynchronizationBenchmark(int num_repeats);
@@ -287,6 +287,28 @@ static int SignedArea (const Math::Vec2<Fix12P4>& vtx1,
 };
 
 static Common::Profiling::TimingCategory rasterization_category("Rasterization");
+
+/**
+ * Records a write to the given rows of a framebuffer, so that the textures cached from its memory
+ * are reloaded. Framebuffers are stored in rows of 8x8 tiles, so whole rows of tiles are marked.
+ * @param first_row First row written to, in framebuffer coordinates
+ * @param last_row Last row written to, in framebuffer coordinates
+ */
+static void MarkFramebufferRowsModified(PAddr addr, u32 bytes_per_pixel, int first_row, int last_row) {
+    const auto& framebuffer = g_state.regs.framebuffer;
+
+    // NOTE: The framebuffer height register contains the actual FB height minus one.
+    first_row = std::max(first_row, 0);
+    last_row = std::min(last_row, static_cast<int>(framebuffer.height));
+    if (first_row > last_row)
+        return;
+
+    const u32 stride = framebuffer.width * bytes_per_pixel;
+    const u32 start = (first_row & ~7) * stride;
+    const u32 end = ((last_row & ~7) + 8) * stride;
+    Memory::MarkRegionModified(addr + start, end - start);
+}
+
 MICROPROFILE_DEFINE(GPU_Rasterization, "GPU", "Rasterization", MP_RGB(50, 50, 240));
 
 /**
@@ -374,6 +396,19 @@ static void ProcessTriangleInternal(const Shader::OutputVertex& v0,
     bool stencil_action_enable = g_state.regs.output_merger.stencil_test.enable && g_state.regs.framebuffer.depth_format == Regs::DepthFormat::D24S8;
     const auto stencil_test = g_state.regs.output_merger.stencil_test;
 
+    // The framebuffer is laid out from bottom to top, so the rows covered by the bounding box are
+    // counted from the framebuffer height
+    const int first_row = regs.framebuffer.height - (max_y >> 4);
+    const int last_row = regs.framebuffer.height - (min_y >> 4);
+    MarkFramebufferRowsModified(regs.framebuffer.GetColorBufferPhysicalAddress(),
+                                GPU::Regs::BytesPerPixel(GPU::Regs::PixelFormat(regs.framebuffer.color_format.Value())),
+                                first_row, last_row);
+    if (regs.output_merger.depth_write_enable || stencil_action_enable) {
+        MarkFramebufferRowsModified(regs.framebuffer.GetDepthBufferPhysicalAddress(),
+                                    Regs::BytesPerDepthPixel(regs.framebuffer.depth_format),
+                                    first_row, last_row);
+    }
+
     // Enter rasterization loop, starting at the center of the topleft bounding box corner.
     // TODO: Not sure if looping through x first might be faster
     for (u16 y = min_y + 8; y < max_y; y += 0x10) {
@@ -1117,6 +1117,8 @@ void RasterizerOpenGL::CommitColorBuffer() {
                     memcpy(pixel, &temp_gl_color_buffer[gl_pixel_index], bytes_per_pixel);
                 }
             }
+
+            Memory::MarkRegionModified(last_fb_color_addr, fb_color_texture.width * fb_color_texture.height * bytes_per_pixel);
         }
     }
 }
@@ -1172,6 +1174,8 @@ void RasterizerOpenGL::CommitDepthBuffer() {
                     }
                 }
             }
+
+            Memory::MarkRegionModified(last_fb_depth_addr, fb_depth_texture.width * fb_depth_texture.height * bytes_per_pixel);
         }
     }
 }
@@ -2,7 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "common/hash.h"
 #include "common/make_unique.h"
 #include "common/math_util.h"
 #include "common/microprofile.h"
@@ -42,7 +41,7 @@ void RasterizerCacheOpenGL::LoadAndBindTexture(OpenGLState &state, unsigned text
         new_texture->height = info.height;
         new_texture->size = info.stride * info.height;
         new_texture->addr = info.physical_address;
-        new_texture->hash = Common::ComputeHash64(texture_src_data, new_texture->size);
+        new_texture->generation = Memory::GetWriteGeneration();
 
         std::unique_ptr<Math::Vec4<u8>[]> temp_texture_buffer_rgba(new Math::Vec4<u8>[info.width * info.height]);
 
@@ -58,7 +57,7 @@ void RasterizerCacheOpenGL::LoadAndBindTexture(OpenGLState &state, unsigned text
     }
 }
 
-void RasterizerCacheOpenGL::InvalidateInRange(PAddr addr, u32 size, bool ignore_hash) {
+void RasterizerCacheOpenGL::InvalidateInRange(PAddr addr, u32 size, bool force) {
     // TODO: Optimize by also inserting upper bound (addr + size) of each texture into the same map and also narrow using lower_bound
     auto cache_upper_bound = texture_cache.upper_bound(addr + size);
 
@@ -67,7 +66,7 @@ void RasterizerCacheOpenGL::InvalidateInRange(PAddr addr, u32 size, bool ignore_
 
         // Flush the texture only if the memory region intersects and a change is detected
         if (MathUtil::IntervalsIntersect(addr, size, info.addr, info.size) &&
-            (ignore_hash || info.hash != Common::ComputeHash64(Memory::GetPhysicalPointer(info.addr), info.size))) {
+            (force || Memory::IsRegionModified(info.addr, info.size, info.generation))) {
 
             it = texture_cache.erase(it);
         } else {
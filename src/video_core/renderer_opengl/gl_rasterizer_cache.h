@@ -23,8 +23,12 @@ public:
         LoadAndBindTexture(state, texture_unit, Pica::DebugUtils::TextureInfo::FromPicaRegister(config.config, config.format));
     }
 
-    /// Invalidate any cached resource intersecting the specified region.
-    void InvalidateInRange(PAddr addr, u32 size, bool ignore_hash = false);
+    /**
+     * Invalidate any cached resource intersecting the specified region whose memory was modified
+     * since it was loaded.
+     * @param force Invalidate the resources even if their memory was not modified
+     */
+    void InvalidateInRange(PAddr addr, u32 size, bool force = false);
 
     /// Invalidate all cached OpenGL resources tracked by this cache manager
     void InvalidateAll();
@@ -35,7 +39,8 @@ private:
         GLuint width;
         GLuint height;
         u32 size;
-        u64 hash;
+        /// Write generation of guest memory when the texture was loaded, see Memory::GetWriteGeneration
+        u32 generation;
         PAddr addr;
     };
 
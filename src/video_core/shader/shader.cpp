@@ -11,6 +11,7 @@
 #include "common/make_unique.h"
 #include "common/microprofile.h"
 #include "common/profiler.h"
+#include "common/string_util.h"
 
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/pica.h"
@@ -45,6 +46,9 @@ void Setup(UnitState<false>& state) {
             jit_shader = iter->second;
         } else {
             jit_shader = jit.Compile();
+            jit.RegisterCode(reinterpret_cast<const u8*>(jit_shader),
+                             Common::StringFromFormat("PicaShader_%016llX+0x%X", static_cast<unsigned long long>(cache_key),
+                                                      g_state.regs.vs.main_offset.Value()));
             shader_map.emplace(cache_key, jit_shader);
         }
     }